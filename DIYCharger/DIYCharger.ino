@@ -30,36 +30,122 @@ Author
 #include <LittleFS.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
+#include "src/hal/hal.h"
+#include "src/filesystem/filesystem.h"
+#include "src/temperatureBus/temperatureBus.h"
+#include "src/acquisition/acquisition.h"
+#include "src/history/history.h"
+#include "src/logReader/logReader.h"
+#include "src/scheduler/scheduler.h"
+#include "src/format/format.h"
+#include "src/log/log.h"
+#include "src/journal/journal.h"
+#include "src/profile/profile.h"
+#include "src/calibration/calibration.h"
+#include "src/slotTable/slotTable.h"
+#include "src/pool/pool.h"
+#include "src/switches/switches.h"
+#include "src/budget/budget.h"
 #include "src/battery/battery.h"
 
 // * * * * * * * * * * * * * Global Variables  * * * * * * * * * * * * * * * //
 
 // Define how many battery slots your project has
-// If you have more than two, you need to take care of MULTIPLEXER and correct
-// signal usage
+// All slots share the analog input A0 through a 16 channel multiplexer
+// (e.g., CD74HC4067), the slot number is the multiplexer channel
 #define slots 1
 
 
-// The timeInterval describes approximate after how many seconds a new entry
-// is added into the measurement file. Low values give higher resolution but
-// also increase the data file size. If we charge/discharge commonly within
-// 1 to 3h, a interval > 30 is sufficient. This will not influence the analysis
-// of the average calculation
-#define WRITEINTERVAL 5
-
+// Multiplexer in front of A0
+// The select pins S0 ... S3 (LSB first) and the time the multiplexer and the
+// ADC input need to settle after switching the channel (us). With a single
+// slot, no multiplexer is needed
+const uint8_t muxPins[] = {D5, D6, D7, D8};
+#define MUXSETTLE 50
+
+
+// Charger / load switch of each slot (HIGH: charger, LOW: discharge
+// resistor), each slot switches independently of the others. With a few
+// slots, each slot has its own pin (PINS, one pin per slot, e.g.,
+// {D1, D0, D3}). With more slots, the switches are driven by cascaded
+// 74HC595 shift registers (SHIFTREGISTER, 8 slots each, the pins are data,
+// clock and latch, e.g., {D1, D0, D3}). The outputs are written once per
+// loop in a single transaction
+#define SWITCHBUS Switches::PINS
+const uint8_t switchPins[] = {D1};
+
+
+// Power budget of the bench (W), supply and heat of the load resistors. A
+// charged cell starts its discharge only if the expected power of all slots
+// (charger module of the profile per charging slot, U^2/R of the load per
+// discharging slot) stays within the budget and the cell is cool enough;
+// a discharge close to TMax is paused (see src/budget/budget.h). At least
+// one discharge runs at a time
+#define POWERBUDGET 30
+
+
+// Each slot gets one voltage sample within this period (ms), independent of
+// the number of slots
+#define SAMPLEPERIOD 10
+
+
+// Each LOGPERIOD (ms) the actual data are offered to the measurement file.
+// A record is only written if the straight line from the last written record
+// misses the data by more than the error bounds of the profile (swinging
+// door compression, see src/swingingDoor/swingingDoor.h), hence the flat
+// parts of a curve need a few records only while the knee near the cut-off
+// voltage is resolved finely. WRITEINTERVAL is the maximum interval (s)
+// between two records. This will not influence the analysis of the average
+// calculation. The file is shown on the serial interface at the end of the
+// test or on the command (optionally the records from t0 to t1 only, s since
+// the start of each phase)
+//     file <slot> [<t0> <t1>]
+#define LOGPERIOD 1000
+#define WRITEINTERVAL 60
+
+
+// Memory (bytes) of the history of the raw samples, shared by all slots. The
+// history holds the raw ADC samples at the full acquisition rate (4 samples
+// in 5 bytes), e.g., 15000 bytes keep the last 2 minutes of a single slot.
+// The history of a slot is dumped to the serial interface if the slot fails
+// or on the command
+//     raw <slot>
+#define HISTORYBYTES 15000
+
+
+// Interval (s) of the checkpoints of a running test. After a reset (brownout,
+// power loss, watchdog), the test of the same cell continues at the last
+// checkpoint; a cell with another voltage is tested anew. Each checkpoint
+// appends 55 bytes to the journal
+#define CHECKPOINTINTERVAL 60
+
+
+// Baud rate of the serial interface. The log messages are sent from a TX
+// ring buffer without blocking (see src/log/log.h, the level is set by
+// LOGLEVEL there), the serial task has to empty it faster than the UART
+// FIFO of 128 bytes drains
+#define BAUDRATE 115200
+#define SERIALPERIOD 5
 
 // Set how many discharging cycles should be performed. For a more reliable
 // analysis, you can do more than one cycle
 #define NCYCLES 1
 
 
-// Temperature sensor input and battery temperature ranges
+// Cell and board of the charger. The voltage limits, the temperature range
+// (see src/profile/profile.h) and the ADC calibration are compile-time
+// constants of the profile. Each slot can have its own calibration of the
+// ADC (see src/calibration/calibration.h), it is set by the commands of the
+// serial interface:
+//     cal <slot> <mV>     Add the actual reading of the slot as reference,
+//                         the reference voltage (mV) is applied to the slot
+//     cal <slot> save     Fit the table to the references and save it
+//     cal <slot>          Print the table of the slot
+typedef Profile<Li18650, WemosD1Mini> ChargerProfile;
+typedef Battery<ChargerProfile> Cell;
 
-    // Minimum cell temperature (dC)
-    float TMIN{5};
 
-    // Maximum cell temperature (dC)
-    float TMAX{28};
+// Temperature sensor input
 
     // On which digital input is the data bus of the DS18B20 connected
     #define TBUS D2
@@ -78,176 +164,684 @@ Author
         };
 
 
-unsigned int nSampling = 20;
-float Rdiss = 5.41;
-
-
 // * * * * * * * * * * * * * * Initialization  * * * * * * * * * * * * * * * //
 
 OneWire TBus(TBUS);
 DallasTemperature TSensors(&TBus);
+TemperatureBus temperatures(TSensors);
+
+// Round-robin acquisition of the cell voltages of all slots
+Acquisition acquisition
+(
+    A0,                     // Analog input
+    muxPins,                // Select pins of the multiplexer
+    slots > 1 ? 4 : 0,      // Number of select pins
+    MUXSETTLE,              // Settle time (us)
+    SAMPLEPERIOD            // Sample period of each slot (ms)
+);
+
+// History of the raw samples of all slots
+uint8_t historyBuffer[HISTORYBYTES];
+History history(historyBuffer, HISTORYBYTES, slots, SAMPLEPERIOD);
+
+// File system session that is kept open (LittleFS is mounted only once)
+FileSystem fileSystem;
+
+// Checkpoints of the running tests
+Journal journal;
+
+// Results of all tested cells
+Catalog catalog;
+
+// ADC calibration of all slots (linear default of the board)
+Calibration calibration(ChargerProfile::mVPerCountQ16);
+
+// The cooperative scheduler that runs all tasks
+Scheduler scheduler;
+
+// Hot data (mode, U, I, C, e, T) of all slots
+SlotTable slotTable;
+
+// Charger / load switches of all slots
+Switches switches(SWITCHBUS, switchPins, slots);
+
+static_assert
+(
+    sizeof(switchPins) == (SWITCHBUS == Switches::PINS ? slots : 3),
+    "Wrong number of switch pins"
+);
+
+// Power and thermal budget of the bench
+Budget<Cell> budget
+(
+    slotTable,
+    slots,
+    POWERBUDGET,
+    ChargerProfile::board::PCharge,
+    ChargerProfile::PDischarge,
+    ChargerProfile::cell::TMax,
+    ChargerProfile::cell::TPause,
+    ChargerProfile::cell::nPausesMax
+);
+
+// The battery objects (static memory, constructed in setup())
+Pool<Cell, slots> batteries;
+
+static_assert(slots <= SlotTable::nMax, "Too many slots");
+
+// Final data of the slot were written
+bool finished[slots];
+
+// Measurement file shown on the serial interface (one at a time), its slot,
+// the slots whose file is still to be shown and their time range (ms)
+LogReader fileReader;
+int fileSlot = -1;
+bool fileRequested[slots];
+uint32_t fileFrom[slots];
+uint32_t fileTo[slots];
+
+// Next part of the statistics report and the slot whose calibration is to
+// be shown (-1 if none), written into the log ring by the serial task
+int reportPart = -1;
+int calibrationSlot = -1;
+
+// Task id of the heartbeat LED
+int heartbeatTask = -1;
+
+
+// Request to show the records of the measurement file of the slot in the
+// time range (ms since the start of the phase)
+void requestFile
+(
+    const int slot,
+    const uint32_t tFrom = 0,
+    const uint32_t tTo = 0xFFFFFFFFUL
+)
+{
+    fileRequested[slot] = true;
+    fileFrom[slot] = tFrom;
+    fileTo[slot] = tTo;
+}
 
 
-// * * * * * * * * * * * * * * Start Function  * * * * * * * * * * * * * * * //
+// * * * * * * * * * * * * * * * * * Tasks * * * * * * * * * * * * * * * * * //
 
-void setup()
+// Take the due voltage samples of all slots
+void acquisitionTask(const int)
 {
-    Serial.begin(9600);
-    pinMode(D1, OUTPUT);
-    pinMode(LED_BUILTIN, OUTPUT);
+    acquisition.tick();
+}
 
-    if (!LittleFS.begin())
-    {
-        Serial.println("Error mounting the file system");
-        return;
-    }
 
-    TSensors.begin();
+// Start or collect the temperature conversion of all sensors
+void temperatureTask(const int)
+{
+    temperatures.tick();
 }
 
 
-// * * * * * * * * * * * * * * Loop Function * * * * * * * * * * * * * * * * //
+// Write the actual data of the slot into its measurement file
+void logTask(const int slot)
+{
+    batteries[slot]->log();
+}
 
-void loop()
+
+// Save the state of a running test of the slot
+void checkpointTask(const int slot)
 {
-    Serial << " START PROGRAMM " << endl;
-    digitalWrite(D1, HIGH);
+    Cell* battery = batteries[slot];
 
-    // Create the battery objects
-    Battery* batteries[slots];
+    if
+    (
+        (battery->mode() == Cell::CHARGE)
+     || (battery->mode() == Cell::DISCHARGE)
+    )
+    {
+        Checkpoint c = battery->checkpoint();
+        journal.write(c);
+    }
+}
 
-    for (int slot = 0; slot < slots; slot++)
+
+// Update the data of the slot and handle the state transitions
+void stateTask(const int slot)
+{
+    Cell* battery = batteries[slot];
+
+    const enum Cell::mode previousMode = battery->mode();
+
+    // Check if battery is not too hot
+    if (!battery->temperatureRangeOkay())
     {
-        Serial.println(" ++ Generate battery slot #" + String(slot));
-        batteries[slot] =
-            new Battery
-            (
-                slot,           // Battery slot
-                NCYCLES,        // Amount of discharge cyclces
-                millis(),       // Offset for calculation
-                WRITEINTERVAL,  // Interval when writting data into file
-                3.3,            // Resistance for discharging
-                TMIN,           // Minimum cell temperature
-                TMAX,           // Maximum cell temperature
-                TSensors        // Object of the DallasTemperature class
-            );
+        battery->setMode(Cell::FAILED);
+    }
 
-        Serial.println(" ++ Set the bit-wise address");
-        // Set bit-wise the address of the temperature sensor
-        // I am not able to do it in the constructor via reference nor pointer
-        for (unsigned int i = 0; i < 8; ++i)
+    // A discharge close to TMax is paused instead of failing the cell
+    if
+    (
+        (battery->mode() == Cell::DISCHARGE)
+     && budget.hot(slot)
+     && budget.pause(slot)
+    )
+    {
+        battery->pause();
+        battery->setOffset(hal().millis());
+
+        if (battery->mode() == Cell::WAIT)
         {
-            batteries[slot]->setTSensorAddress(i, TSensorAddresses[slot][i]);
+            budget.wait(slot);
         }
     }
-    
-    bool finished = false;
 
-    // Own loop in order to not destroy the object
-    do
+    LOGD("Temperature = " << Format::Fixed(battery->T(), 2) << endl);
+
+    LOGD
+    (
+        "Voltage = " << Format::Fixed(battery->U(), 4) << " ("
+        << battery->nSamplesU() << " samples)" << endl
+    );
+
+    // First check if the battery is already tested or did fail
+    // we are finished. Otherwise we will do the analysis of the battery
+    if
+    (
+        (battery->mode() != Cell::TESTED)
+     && (battery->mode() != Cell::FAILED)
+    )
     {
-        // Loop through all batteries
-        for (auto& battery : batteries)
+        // Check if new battery was inserted
+        if(battery->checkIfReplacedOrEmpty())
         {
-            // Check if battery is not too hot
-            if (!battery->temperatureRangeOkay())
-            {
-                battery->setMode(Battery::FAILED);
-            }
+            // Same cell as before a reset, continue its test
+            Checkpoint c;
 
-            Serial.println("Temperature = " + String(battery->T()));
-
-            // First check if the battery is already tested or did fail
-            // we are finished. Otherwise we will do the analysis of the battery
             if
             (
-                (battery->mode() != Battery::TESTED)
-             && (battery->mode() != Battery::FAILED)
+                (battery->mode() == Cell::FIRST)
+             && journal.read(slot, c)
+             && battery->resume(c)
             )
             {
-                // Check if new battery was inserted
-                if(battery->checkIfReplacedOrEmpty())
+                LOGI(" +++ TEST RESUMED +++ \n");
+
+                // The budget admits a resumed discharge like a new one,
+                // after a reset all slots would discharge at once otherwise
+                if
+                (
+                    (battery->mode() == Cell::WAIT)
+                 || (battery->mode() == Cell::DISCHARGE)
+                )
                 {
-                    if (battery->mode() == Battery::FIRST)
-                    {
-                        Serial<< " +++ NEW BATTERY DETECTED - RESET +++ \n";
-                        battery->setOffset(millis());
-                        battery->setU();
-                        battery->setMode(Battery::CHARGE);
-                        battery->removeDataFile();
-                    }
+                    budget.wait(slot);
                 }
 
-                // Only execute the rest, if a battery is found
                 if
                 (
-                    (battery->mode() != Battery::EMPTY)
-                 && (battery->mode() != Battery::FIRST)
+                    (battery->mode() == Cell::DISCHARGE)
+                 && !budget.admit(slot)
                 )
                 {
-                    // Update all data corresponding on the battery mode
-                    battery->update();
+                    battery->pause();
+                    battery->setOffset(hal().millis());
+                }
+            }
+
+            if (battery->mode() == Cell::FIRST)
+            {
+                LOGI(" +++ NEW BATTERY DETECTED - RESET +++ \n");
+                battery->setOffset(hal().millis());
+                battery->setU();
+                battery->setMode(Cell::SCREEN);
+                battery->removeDataFile();
+                budget.clear(slot);
+            }
+        }
+
+        // Pulse test of the new cell, bad cells are rejected within
+        // seconds instead of after a full cycle
+        if (battery->mode() == Cell::SCREEN)
+        {
+            if (!battery->screening() && battery->mode() != Cell::FAILED)
+            {
+                battery->setOffset(hal().millis());
+                battery->setMode(Cell::CHARGE);
+            }
+        }
+
+        // The charged cell starts its discharge when the power and thermal
+        // budget of the bench admits it
+        if (battery->mode() == Cell::WAIT && budget.admit(slot))
+        {
+            battery->setOffset(hal().millis());
+            battery->setMode(Cell::DISCHARGE);
+        }
 
-                    if (battery->mode() == Battery::CHARGE)
+        // Only execute the rest, if a battery is found
+        if
+        (
+            (battery->mode() != Cell::EMPTY)
+         && (battery->mode() != Cell::FIRST)
+         && (battery->mode() != Cell::SCREEN)
+         && (battery->mode() != Cell::WAIT)
+         && (battery->mode() != Cell::FAILED)
+        )
+        {
+            // Update all data corresponding on the battery mode
+            battery->update();
+
+            if (battery->mode() == Cell::CHARGE)
+            {
+                if(!battery->charging())
+                {
+                    battery->setOffset(hal().millis());
+                    if(battery->checkIfFullyTested())
                     {
-                        if(!battery->charging())
-                        {
-                            battery->setOffset(millis());
-                            if(battery->checkIfFullyTested())
-                            {
-                                battery->setMode(Battery::TESTED);
-                                battery->correctAverageData();
-                            }
-                            else
-                            {
-                                battery->setMode(Battery::DISCHARGE);
-                            }
-                        }
+                        battery->setMode(Cell::TESTED);
+                        battery->correctAverageData();
                     }
-
-                    if (battery->mode() == Battery::DISCHARGE)
+                    else
                     {
-                        if(!battery->discharging())
-                        {
-                            battery->incrementDischarges();
-                            battery->setMode(Battery::CHARGE);
-                            battery->reset();
-                            battery->setOffset(millis());
-                        }
+                        battery->setMode(Cell::WAIT);
+                        budget.wait(slot);
                     }
                 }
             }
-            else
+
+            if (battery->mode() == Cell::DISCHARGE)
+            {
+                if(!battery->discharging())
+                {
+                    battery->incrementDischarges();
+                    battery->setMode(Cell::CHARGE);
+                    battery->reset();
+                    battery->setOffset(hal().millis());
+                }
+            }
+        }
+    }
+    else
+    {
+        if (!finished[slot])
+        {
+            LOGI("Finished ..." << endl);
+            finished[slot] = true;
+
+            // Add further information to the file, rename it, update
+            // the cellID file and sent it to the server. A test resumed
+            // after the final data or the catalog entry were written
+            // keeps them (the summary holds the cell ID)
+            if (!battery->finalized())
+            {
+                battery->addFinalDataToFile();
+                battery->updateFileName();
+            }
+
+            CatalogEntry entry = battery->catalogEntry();
+            CatalogEntry written;
+
+            if (!catalog.find(entry.cellID, written))
+            {
+                catalog.append(entry);
+            }
+            //battery->sentDataToServer();
+            requestFile(slot);
+        }
+    }
+
+    // Keep the raw samples which led to the failure
+    if (battery->mode() == Cell::FAILED && previousMode != Cell::FAILED)
+    {
+        history.dump(slot);
+    }
+
+    // Save each state transition immediately
+    if (battery->mode() != previousMode)
+    {
+        Checkpoint c = battery->checkpoint();
+        journal.write(c);
+    }
+}
+
+
+// Show that the chip is running by simply putting the LED on for 1 ms
+// every second (the LED is active low)
+void ledTask(const int)
+{
+    static bool on = false;
+
+    on = !on;
+
+    hal().digitalWrite(LED_BUILTIN, on ? LOW : HIGH);
+    scheduler.setPeriod(heartbeatTask, on ? 1 : 999);
+}
+
+
+// Show the next lines of the measurement file or start to show the next
+// requested one, as much as the UART takes without waiting
+void showFile(const size_t budget)
+{
+    if (fileSlot < 0)
+    {
+        for (int slot = 0; slot < slots && fileSlot < 0; ++slot)
+        {
+            if (fileRequested[slot])
             {
-                if (!finished)
+                fileRequested[slot] = false;
+
+                if (batteries[slot]->showDataFileContent(fileReader))
                 {
-                       Serial<< "Finished ...";
-                    finished = true;
-
-                    // Add further information to the file, rename it, update
-                    // the cellID file and sent it to the server
-                    battery->addFinalDataToFile();
-                    battery->updateFileName();
-                    //battery->sentDataToServer();
-                    battery->showDataFileContent();
+                    fileReader.timeRange(fileFrom[slot], fileTo[slot]);
+                    fileSlot = slot;
                 }
-                delay(60000);
             }
         }
 
-        // Show that the chip is running by simply putting the LED on for 1s
-        digitalWrite(LED_BUILTIN, LOW);
-        delay(1);
-        digitalWrite(LED_BUILTIN, HIGH);
-        delay(1000);
+        // The header follows after the log message of the start
+        return;
     }
-    while (true);
 
-    // Destroy all objects if we ever went to this one
-    for (int id = 0; id < slots; ++id)
+    if (budget < LogReader::lineSize)
     {
-        delete batteries[id];
+        return;
+    }
+
+    if (!fileReader.next(Serial, budget))
+    {
+        Serial << endl;
+        fileSlot = -1;
+    }
+}
+
+
+// Write the next part of the statistics report into the log ring; each part
+// fits into the empty ring, hence no line is dropped
+void reportNext()
+{
+    const int part = reportPart++;
+
+    if (part == 0)
+    {
+        scheduler.report(logger);
+    }
+    else if (part == 1)
+    {
+        acquisition.report(logger);
+        switches.report(logger);
+        budget.report(logger);
+        FileSystem::report(logger);
+    }
+    else if (part < 2 + slots)
+    {
+        const int slot = part - 2;
+
+        batteries[slot]->screen().report(logger);
+        batteries[slot]->endOfCharge().report(logger);
+        batteries[slot]->compression().report(logger);
     }
+    else
+    {
+        logger.report(logger);
+
+        logger
+            << "Heap free / largest block (B): " << hal().freeHeap()
+            << " / " << hal().maxFreeBlock() << endl;
+
+        reportPart = -1;
+    }
+}
+
+
+// Send the pending log messages, as much as the UART takes without waiting,
+// then the next part of a report or the next lines of a running dump of the
+// history or of a file
+void serialTask(const int)
+{
+    logger.pump();
+
+    if (logger.pending())
+    {
+        return;
+    }
+
+    if (calibrationSlot >= 0)
+    {
+        calibration.print(logger, calibrationSlot);
+        calibrationSlot = -1;
+    }
+    else if (reportPart >= 0)
+    {
+        reportNext();
+    }
+    else if (history.dumping())
+    {
+        history.dumpNext(Serial, Serial.availableForWrite());
+    }
+    else
+    {
+        showFile(Serial.availableForWrite());
+    }
+}
+
+
+// Execute a command of the serial interface
+void command(const char* line)
+{
+    int slot = -1;
+    char arg[8] = "";
+
+    // Measurement file of the slot, optionally the records from t0 to t1
+    // (s) only
+    unsigned long t0 = 0;
+    unsigned long t1 = 0xFFFFFFFFUL/1000;
+
+    if
+    (
+        sscanf(line, "file %d %lu %lu", &slot, &t0, &t1) >= 1
+     && slot >= 0
+     && slot < slots
+     && t0 <= t1
+     && t1 <= 0xFFFFFFFFUL/1000
+    )
+    {
+        requestFile(slot, 1000*t0, 1000*t1);
+        return;
+    }
+
+    if (sscanf(line, "raw %d", &slot) == 1 && slot >= 0 && slot < slots)
+    {
+        if (!history.dump(slot))
+        {
+            LOGW("History of slot #" << slot << " not available" << endl);
+        }
+
+        return;
+    }
+
+    if
+    (
+        sscanf(line, "cal %d %7s", &slot, arg) < 1
+     || slot < 0
+     || slot >= slots
+    )
+    {
+        LOGW("Unknown command '" << line << "'" << endl);
+        return;
+    }
+
+    if (!strcmp(arg, "save"))
+    {
+        if (calibration.calibrate(slot))
+        {
+            batteries[slot]->setThresholds();
+            LOGI(" ++ Calibration of slot #" << slot << " saved" << endl);
+        }
+    }
+    else if (arg[0])
+    {
+        const uint32_t countsQ4 = batteries[slot]->countsQ4();
+
+        if (calibration.addReference(slot, countsQ4, atoi(arg)))
+        {
+            LOGI
+            (
+                " ++ Reference " << atoi(arg) << " mV at "
+                << Format::Fixed(countsQ4/16.f, 2) << " counts" << endl
+            );
+        }
+    }
+    else
+    {
+        calibrationSlot = slot;
+    }
+}
+
+
+// Read the commands of the serial interface (one per line)
+void commandTask(const int)
+{
+    static char line[24];
+    static unsigned int n = 0;
+
+    while (Serial.available() > 0)
+    {
+        const char c = char(Serial.read());
+
+        if (c == '\n' || c == '\r')
+        {
+            line[n] = '\0';
+
+            if (n)
+            {
+                command(line);
+            }
+
+            n = 0;
+        }
+        else if (n < sizeof(line) - 1)
+        {
+            line[n++] = c;
+        }
+    }
+}
+
+
+// Request the report of the timing statistics of the scheduler, the file
+// system usage and the heap (both heap values must stay flat during a test),
+// the serial task sends it in parts (see reportNext)
+void statisticsTask(const int)
+{
+    if (reportPart < 0)
+    {
+        reportPart = 0;
+    }
+}
+
+
+// * * * * * * * * * * * * * * Start Function  * * * * * * * * * * * * * * * //
+
+void setup()
+{
+    Serial.begin(BAUDRATE);
+    switches.begin();
+    hal().pinMode(LED_BUILTIN, OUTPUT);
+
+    if (!fileSystem.startFS())
+    {
+        LOGE("Error mounting the file system" << endl);
+        logger.flush();
+        return;
+    }
+
+    TSensors.begin();
+
+    LOGI(" START PROGRAMM " << endl);
+
+    // Calibration of the slots, before the slots convert their limits
+    calibration.load();
+
+    // Create the battery objects
+    for (int slot = 0; slot < slots; slot++)
+    {
+        LOGI(" ++ Generate battery slot #" << slot << endl);
+        batteries.create
+        (
+            slot,
+            slot,           // Battery slot
+            NCYCLES,        // Amount of discharge cyclces
+            hal().millis(), // Offset for calculation
+            WRITEINTERVAL,  // Maximum interval of the data in the file
+            temperatures,   // Temperature service of the sensor bus
+            acquisition,    // Voltage acquisition of all slots
+            calibration,    // ADC calibration of all slots
+            slotTable,      // Hot data of all slots
+            switches        // Charger / load switches of all slots
+        );
+
+        finished[slot] = false;
+        fileRequested[slot] = false;
+        fileFrom[slot] = 0;
+        fileTo[slot] = 0;
+
+        LOGD(" ++ Set the bit-wise address" << endl);
+        // Set bit-wise the address of the temperature sensor
+        // I am not able to do it in the constructor via reference nor pointer
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            batteries[slot]->setTSensorAddress(i, TSensorAddresses[slot][i]);
+        }
+    }
+
+    // First conversion of all temperature sensors (blocking), afterwards
+    // the conversions run in the background
+    temperatures.begin();
+
+    // Select the first multiplexer channel, the samples go into the history
+    // as well
+    acquisition.record(history);
+    acquisition.begin();
+
+    // Setup the tasks (name, function, argument, period (ms), deadline (ms))
+    // The deadline is the maximum allowed delay of the start of a task
+    for (int slot = 0; slot < slots; slot++)
+    {
+        scheduler.add("state", stateTask, slot, 1000, 100);
+        scheduler.add("log", logTask, slot, LOGPERIOD, 500);
+        scheduler.add
+        (
+            "checkpoint",
+            checkpointTask,
+            slot,
+            1000*CHECKPOINTINTERVAL,
+            1000
+        );
+    }
+
+    scheduler.add
+    (
+        "acquisition",
+        acquisitionTask,
+        -1,
+        SAMPLEPERIOD >= slots ? SAMPLEPERIOD/slots : 1,
+        5
+    );
+    scheduler.add("temperature", temperatureTask, -1, 50);
+    scheduler.add("serial", serialTask, -1, SERIALPERIOD, 5);
+    scheduler.add("command", commandTask, -1, 100);
+    heartbeatTask = scheduler.add("heartbeat", ledTask, -1, 1000, 10);
+    scheduler.add("statistics", statisticsTask, -1, 600000);
+}
+
+
+// * * * * * * * * * * * * * * Loop Function * * * * * * * * * * * * * * * * //
+
+void loop()
+{
+    // Run all due tasks, a slow or finished slot never blocks the others
+    scheduler.run();
+
+    // Write the switch states the slots requested in this pass
+    switches.apply();
 }
 
 
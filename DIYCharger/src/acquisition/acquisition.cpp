@@ -0,0 +1,188 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "acquisition.h"
+#include "../log/log.h"
+#include "../hal/hal.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int Acquisition::nMax;
+const unsigned int Acquisition::nSelectPinsMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Acquisition::Acquisition
+(
+    const uint8_t pin,
+    const uint8_t* selectPins,
+    const uint8_t nSelectPins,
+    const unsigned long settle,
+    const unsigned long period
+)
+:
+    pin_(pin),
+    nSelectPins_(nSelectPins < nSelectPinsMax ? nSelectPins : nSelectPinsMax),
+    settle_(settle),
+    period_(1000*period),
+    n_(0),
+    history_(nullptr),
+    next_(0),
+    tSelect_(0),
+    tDue_(0),
+    samples_(0),
+    settleWaits_(0),
+    overruns_(0)
+{
+    for (uint8_t i = 0; i < nSelectPins_; ++i)
+    {
+        selectPins_[i] = selectPins[i];
+    }
+}
+
+
+Acquisition::~Acquisition()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+void Acquisition::select(const uint8_t channel)
+{
+    for (uint8_t i = 0; i < nSelectPins_; ++i)
+    {
+        hal().digitalWrite(selectPins_[i], (channel >> i) & 1 ? HIGH : LOW);
+    }
+
+    tSelect_ = hal().micros();
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+bool Acquisition::attach(const int channel, Sampler& sampler)
+{
+    if (n_ == nMax || channel < 0 || channel >= (1 << nSelectPins_))
+    {
+        LOGE("ERROR: Channel " << channel << " can not be acquired" << endl);
+        return false;
+    }
+
+    channels_[n_] = uint8_t(channel);
+    samplers_[n_] = &sampler;
+    ++n_;
+
+    return true;
+}
+
+
+void Acquisition::record(History& history)
+{
+    history_ = &history;
+}
+
+
+void Acquisition::begin()
+{
+    for (uint8_t i = 0; i < nSelectPins_; ++i)
+    {
+        hal().pinMode(selectPins_[i], OUTPUT);
+    }
+
+    next_ = 0;
+
+    if (n_)
+    {
+        select(channels_[next_]);
+    }
+
+    tDue_ = hal().micros();
+}
+
+
+void Acquisition::tick()
+{
+    if (!n_)
+    {
+        return;
+    }
+
+    // Time between two samples (the channels share the period)
+    const unsigned long dt = period_/n_;
+
+    const unsigned long tStart = hal().micros();
+
+    // Take all due samples, at most one per channel
+    for (unsigned int k = 0; k < n_; ++k)
+    {
+        const unsigned long t = hal().micros();
+
+        if (long(t - tDue_) < 0)
+        {
+            return;
+        }
+
+        // Normally the channel settled already since the last sample
+        const unsigned long tSettled = t - tSelect_;
+
+        if (nSelectPins_ && tSettled < settle_)
+        {
+            hal().delayMicroseconds(settle_ - tSettled);
+            ++settleWaits_;
+        }
+
+        const int raw = hal().analogRead(pin_);
+
+        samplers_[next_]->add(raw);
+        ++samples_;
+
+        if (history_)
+        {
+            history_->add(channels_[next_], raw);
+        }
+
+        // Select the next channel, it settles until the next tick
+        next_ = (next_ + 1) % n_;
+
+        if (n_ > 1)
+        {
+            select(channels_[next_]);
+        }
+
+        tDue_ += dt;
+    }
+
+    // Still behind after a full round, skip the missed samples instead of
+    // catching up with a burst. The new due time is based on the start of
+    // the tick, i.e., it stays in phase with the calling task
+    if (long(hal().micros() - tDue_) >= 0)
+    {
+        ++overruns_;
+        tDue_ = tStart + dt;
+    }
+}
+
+
+void Acquisition::report(Print& out) const
+{
+    out << "# Acquisition channels: " << n_
+        << ", period (ms): " << period_/1000
+        << ", samples: " << samples_
+        << ", settle waits: " << settleWaits_
+        << ", overruns: " << overruns_ << endl;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,166 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Acquisition engine for n slots which share the single ADC of the ESP8266
+    through an analog multiplexer (e.g., CD74HC4067). Each slot registers
+    its sampler with its multiplexer channel. The channels are sampled in a
+    fixed round-robin schedule: within one period every channel gets exactly
+    one sample, hence the sample rate per slot is guaranteed and does not
+    depend on the number of slots (as long as the ADC is fast enough).
+
+    The acquisition is pipelined. Directly after a channel was sampled, the
+    multiplexer switches to the next channel, so it settles while the rest
+    of the program runs. Only if the next sample is due before the settle
+    time passed, the remaining settle time is waited.
+
+    Without multiplexer (no select pins), all channels are read directly.
+
+    Optionally, each raw sample is also added to the history of its channel
+    (see history.h).
+
+SourceFiles
+    acquisition.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef acquisition_h
+#define acquisition_h
+
+#include <Arduino.h>
+#include "../sampler/sampler.h"
+#include "../history/history.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                         Class Acquisition Declaration
+\*---------------------------------------------------------------------------*/
+
+class Acquisition
+{
+public:
+
+    // Maximum number of channels (16 channel multiplexer)
+    static const unsigned int nMax = 16;
+
+    // Maximum number of select pins
+    static const unsigned int nSelectPinsMax = 4;
+
+
+private:
+
+    // Private class data
+
+        // Analog pin
+        uint8_t pin_;
+
+        // Select pins of the multiplexer (LSB first)
+        uint8_t selectPins_[nSelectPinsMax];
+
+        // Number of select pins
+        uint8_t nSelectPins_;
+
+        // Settle time of the multiplexer and the ADC input (us)
+        unsigned long settle_;
+
+        // Time in which each channel is sampled once (us)
+        unsigned long period_;
+
+        // Channel and sampler of each attached slot
+        uint8_t channels_[nMax];
+        Sampler* samplers_[nMax];
+
+        // Number of attached channels
+        unsigned int n_;
+
+        // History of the raw samples (optional)
+        History* history_;
+
+        // Index of the selected channel (next to be sampled)
+        unsigned int next_;
+
+        // Time of the channel selection (us)
+        unsigned long tSelect_;
+
+        // Time at which the next sample is due (us)
+        unsigned long tDue_;
+
+
+        // Statistics
+
+            // Number of samples
+            unsigned long samples_;
+
+            // Number of samples which had to wait for the settle time
+            unsigned long settleWaits_;
+
+            // Number of periods the acquisition could not keep up
+            unsigned long overruns_;
+
+
+    // Private Member Functions
+
+        // Switch the multiplexer to the given channel
+        void select(const uint8_t);
+
+
+public:
+
+    // Constructor (analog pin, select pins, number of select pins, settle
+    // time (us), period in which each channel is sampled once (ms))
+    Acquisition
+    (
+        const uint8_t,
+        const uint8_t*,
+        const uint8_t,
+        const unsigned long,
+        const unsigned long
+    );
+
+    // Destructor
+    ~Acquisition();
+
+
+    // Public Return Functions
+
+        // Return the number of attached channels
+        inline unsigned int size() const { return n_; }
+
+        // Return the sample period of each channel (ms)
+        inline unsigned long period() const { return period_/1000; }
+
+
+    // Public Member Functions
+
+        // Register the sampler of the given multiplexer channel
+        bool attach(const int, Sampler&);
+
+        // Add all raw samples to the history as well
+        void record(History&);
+
+        // Configure the select pins and select the first channel
+        void begin();
+
+        // Take all samples which are due (call at least every
+        // period()/size() ms)
+        void tick();
+
+        // Print the statistics of the acquisition
+        void report(Print&) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
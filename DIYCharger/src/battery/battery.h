@@ -18,8 +18,12 @@ Description
     state and collects all necessary data into a single file. After the test
     for a battery is finished, the data are sent to a webserver.
 
+    The class template is specialized at compile time by a Profile of the
+    cell and the board (see profile.h), all thresholds are constants and
+    the voltage limits are compared as raw ADC counts.
+
 SourceFiles
-    battery.cpp
+    batteryI.h
 
 \*---------------------------------------------------------------------------*/
 
@@ -28,8 +32,22 @@ SourceFiles
 
 #include <Arduino.h>
 #include <Streaming.h>
-#include <DallasTemperature.h>
+#include "../hal/hal.h"
+#include "../sampler/sampler.h"
+#include "../temperatureBus/temperatureBus.h"
+#include "../acquisition/acquisition.h"
+#include "../integrator/integrator.h"
+#include "../endOfCharge/endOfCharge.h"
+#include "../fastScreen/fastScreen.h"
+#include "../swingingDoor/swingingDoor.h"
+#include "../journal/journal.h"
+#include "../catalog/catalog.h"
+#include "../calibration/calibration.h"
 #include "../writerReader/writerReader.h"
+#include "../profile/profile.h"
+#include "../slotTable/slotTable.h"
+#include "../switches/switches.h"
+#include "../log/log.h"
 
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
 
@@ -38,31 +56,49 @@ SourceFiles
                            Class Battery Declaration
 \*---------------------------------------------------------------------------*/
 
+template<class Profile>
 class Battery
 :
     public WriterReader
 {
 public:
 
-    // The modes to distiguish between different states
-    enum mode { CHARGE, DISCHARGE, EMPTY, FIRST, TESTED, FAILED };
+    // The modes to distiguish between different states (WAIT: the charged
+    // cell waits for the power and thermal budget of its discharge)
+    enum mode
+    {
+        CHARGE, DISCHARGE, EMPTY, FIRST, TESTED, FAILED, SCREEN, WAIT
+    };
 
 
 private:
 
     // Private class data
 
-        // Status of program (charge / discharge or no battery inserted)
-        mode mode_;
-
         // The battery slot number
         int slot_;
 
-        // Channel for SLI
+        // Multiplexer channel of the cell voltage (equals the slot)
         int channel_;
 
-        // Oversampling
-        int overSampling_;
+        // Sampler of the cell voltage (raw ADC counts), filled by the
+        // acquisition engine
+        Sampler sampler_;
+
+        // Calibration of the ADC of all slots
+        const Calibration& calibration_;
+
+        // Charger / load switches of all slots
+        Switches& switches_;
+
+        // Empty, cut-off and full voltage in ADC counts of the slot (1/16
+        // counts)
+        uint32_t emptyQ4_;
+        uint32_t cutOffQ4_;
+        uint32_t fullQ4_;
+
+        // Number of samples of the latest voltage reading
+        mutable unsigned int nU_;
 
         // Number of total discharge cycles to be perfomed
         unsigned int nTotalDischarges_;
@@ -79,26 +115,14 @@ private:
         // Offset of time (ms)
         unsigned long tOffset_;
 
+        // Start of the test, board clock (ms)
+        unsigned long tStart_;
 
-    // Variables for capacity analysis
 
-        // Resistance used (Ohm)
-        float R_;
-
-        // Actual voltage (V)
-        float U_;
-
-        // Actual current (mA)
-        float I_;
-
-        // Actual dissipated power (mW)
-        float P_;
-
-        // Total battery capacity (mAh)
-        float C_;
+    // Variables for capacity analysis
 
-        // Total battery energy (mWh)
-        float e_;
+        // Actual dissipated power (nW)
+        int64_t P_;
 
         // Average capacity if more cycles are performed (mAh)
         float CAve_;
@@ -106,39 +130,52 @@ private:
         // Average battery energy if more cycles are performed (mWh)
         float eAve_;
 
-        // Container that stores the last n voltage data
-        // DEPRECIATED: will be replaced by RShunt
-        float UBat_[2];
+        // Raw capacity and energy at the start of the discharge (a paused
+        // discharge does not count)
+        int64_t CStart_;
+        int64_t eStart_;
 
+        // The discharge is repeated after a pause (the integrals of the
+        // recharge do not count)
+        bool repeat_;
 
-    // Temperature sensor data
+        // End-of-charge detector of the charge phase
+        EndOfCharge endOfCharge_;
 
-        // Actual temperature (dC)
-        float T_;
+        // Pulse test of a new cell (SCREEN mode)
+        FastScreen screen_;
 
-        // Min-Temperature of cell (dC)
-        const float TMin_;
 
-        // Max-Temperature of cell (dC)
-        const float TMax_;
+    // Temperature sensor data
+
+        // Lowest and highest temperature measured during the test (dC)
+        float TLow_;
+        float THigh_;
 
         // Temperature sensor address (DS18B20)
         byte TSensorAddress_[8];
 
-        // Reference to the sensors object
-        DallasTemperature& sensors_;
+        // Reference to the temperature service of the sensor bus
+        TemperatureBus& sensors_;
 
 
-    // Variables for IO operations
+    // Hot data of the slot
+
+        // Table of all slots, the mode, voltage, current, capacity, energy
+        // and temperature of this battery are in the row slot_
+        SlotTable& hot_;
 
-        // File name
-        String fileName_;
 
-        // Write interval (s)
+    // Variables for IO operations
+
+        // Maximum interval between two records of the measurement file (s)
         unsigned long writeInterval_;
 
-        // Actual time passed (s)
-        unsigned long tPassed_;
+        // Compression of the records of the measurement file
+        SwingingDoor door_;
+
+        // Previous record offered to the compression (t, U, I, P, C, e)
+        float record_[6];
 
 
 public:
@@ -150,10 +187,11 @@ public:
         const int,
         const unsigned long,
         const unsigned long,
-        const float,
-        const float,
-        const float,
-        DallasTemperature&
+        TemperatureBus&,
+        Acquisition&,
+        const Calibration&,
+        SlotTable&,
+        Switches&
     );
 
     // Destroctor
@@ -177,6 +215,10 @@ public:
         // Set the mode
         void setMode(const mode m);
 
+        // Convert the voltage limits into ADC counts with the calibration
+        // of the slot (again after a new calibration)
+        void setThresholds();
+
         // Set bitwise the address of the temperature sensor
         // I am too stupid to do it in the constructor -.-
         void setTSensorAddress(const unsigned int, const byte);
@@ -190,17 +232,60 @@ public:
         // Return battery slot
         inline int slot() const { return slot_; };
 
+        // Return the multiplexer channel
+        inline int channel() const { return channel_; };
+
         // Return the voltage (V)
-        inline float U() const { return U_; }
+        inline float U() const { return hot_.U[slot_]; }
+
+        // Return the current (mA)
+        inline float I() const { return hot_.I[slot_]/1000.f; }
+
+        // Return the dissipated power (mW)
+        inline float P() const { return P_/1e6f; }
+
+        // Return the capacity (mAh)
+        inline float C() const { return hot_.C[slot_].hours(1000); }
+
+        // Return the energy (mWh)
+        inline float e() const { return hot_.e[slot_].hours(1e6); }
+
+        // Return how many samples are in the latest voltage reading
+        inline unsigned int nSamplesU() const { return nU_; }
+
+        // Return the averaged ADC counts of the voltage over the full
+        // oversampling (1/16 counts)
+        inline uint32_t countsQ4() const
+        {
+            return sampler_.meanQ4(sampler_.n(), Profile::board::trim);
+        }
 
         // Return the temperature (dC)
-        inline float T() const { return T_; }
+        inline float T() const { return hot_.T[slot_]; }
+
+        // Return the time stamp of the temperature (ms)
+        inline unsigned long tT() const { return sensors_.tT(slot_); }
 
         // Return the number of discharges
         inline unsigned long nDischarges () const { return nDischarges_; }
 
         // Return the mode
-        inline enum mode mode() const { return mode_; };
+        inline enum mode mode() const
+        {
+            return static_cast<enum mode>(hot_.mode[slot_]);
+        }
+
+        // Return the end-of-charge detector
+        inline const EndOfCharge& endOfCharge() const { return endOfCharge_; }
+
+        // Return the fast screening
+        inline const FastScreen& screen() const { return screen_; }
+
+        // Return the maximum interval between two records (s)
+        inline unsigned long writeInterval() const { return writeInterval_; }
+
+        // Return the compression of the measurement file
+        inline const SwingingDoor& compression() const { return door_; }
 
         //inline const byte* sensorAddress() { return TSensorAddress_; }
 
@@ -216,10 +301,39 @@ public:
         // Reset all data to zero
         void reset();
 
+        // Stop the discharge before the cut-off (e.g., the cell gets too
+        // hot), the data of the discharge are dropped and the cell is
+        // charged again (WAIT after a short discharge, CHARGE otherwise)
+        void pause();
+
         // Update all data which are needed based on the mode() of
         // the battery (charging/discharging)
         void update();
 
+        // Offer the actual data to the measurement file (only if the
+        // battery is charged or discharged), the compression decides if
+        // it is written. Buffered records are committed after their
+        // maximum age
+        void log();
+
+        // Return the checkpoint of the test state (the buffered measurement
+        // data are not committed, a reset loses at most their maximum age)
+        Checkpoint checkpoint() const;
+
+        // Return the catalog record of the finished test (call after
+        // addFinalDataToFile, which assigns the cell ID)
+        CatalogEntry catalogEntry() const;
+
+        // Continue the test of a checkpoint if the cell in the slot is the
+        // same (mode, phase time and voltage), return false otherwise. A
+        // finished test is resumed in its final mode, its final data are
+        // written again if missing (see finalized())
+        bool resume(const Checkpoint&);
+
+        // Function that determines if the fast screening of a new cell is
+        // still running, a rejected cell is set to FAILED
+        bool screening();
+
         // Function that determines if we are still charging
         bool charging();
 
@@ -237,22 +351,31 @@ public:
 
         // Function that removed the battery file from previous analysis, if
         // something went wrong (clearing for startup)
-        void removeDataFile() const;
+        void removeDataFile();
 
-        // Show the data file content
-        void showDataFileContent() const;
+        // Open the data file in the reader which shows its content, return
+        // false if not available
+        bool showDataFileContent(LogReader&);
 
         // Add the final data to the file such as
         // ++ amount of discharges
         // ++ average values
         // ++ current (from last load) voltage (after battery is switched off
         //    from the power supply - used for the 30-days discharging)
-        // ++ Current time-stamp (if available)
-        void addFinalDataToFile() const;
+        // ++ start and end time of the test (board clock)
+        // The cell ID is assigned here and the id file is updated
+        void addFinalDataToFile();
+
+        // Return true if the final data are already in the file (e.g.,
+        // written before a reset), the cell ID is taken from the file
+        bool finalized();
+
+        // Commit the buffered measurement data to the file (e.g., before
+        // shutting down)
+        void flush();
 
         // Update the file name of the measurement data (set the correct name)
-        // from 'slot_1' to e.g., 'battery_<ID>'. Furthermore, update the id
-        // file
+        // from 'slot_1' to e.g., 'battery_<ID>'
         void updateFileName() const;
 
         // Function that determines if the battery temperature is okay
@@ -263,28 +386,45 @@ private:
 
     // Private Member Functions
 
-        // Read the digital signal at A0, convert it to a voltage and return it
+        // Return the name of the measurement file (in the slot table)
+        inline const char* fileName() const { return hot_.fileName[slot_]; }
+
+        // Write the record into the measurement file
+        void write(const float*);
+
+        // Write the pending record of the compression and end the series
+        // (end of a charge or discharge phase)
+        void closeSeries();
+
+        // Return the averaged digital signal at A0 converted to a voltage
         float readU() const;
 
-        // Convert the digital to an analog value
-        // This function provides a mapping from an digital value to an analog
-        // value by using an linear interpolation approach
-        float DtoA
-        (
-            const unsigned int,
-            const int,
-            const int,
-            const float,
-            const float
-        ) const;
-
-        // Read the actual temperature of the sensor at D2 and return the value
-        // in [dC]
+        // Return the averaged digital signal at A0 converted to mV with
+        // the calibration of the slot (integers only)
+        int32_t readmV() const;
+
+        // Return the averaged ADC counts with the adaptive oversampling
+        // (1/16 counts)
+        uint32_t readCountsQ4() const;
+
+        // Return true if the ADC counts are close to a voltage limit
+        bool nearLimit(const uint32_t) const;
+
+        // Return true if the averaged ADC counts are below the threshold
+        // (1/16 counts, see Profile)
+        bool below(const uint32_t) const;
+
+        // Return the latest temperature of the sensor at D2 in [dC] (cached
+        // by the temperature service, never blocks)
         float readT() const;
 };
 
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
 
+#include "batteryI.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
 #endif
 
 // ************************************************************************* //
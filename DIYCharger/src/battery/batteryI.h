@@ -0,0 +1,782 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * * //
+
+template<class Profile>
+Battery<Profile>::Battery
+(
+    const int slot,
+    const int nDischargeCycles,
+    const unsigned long tOffset,
+    const unsigned long writeInterval,
+    TemperatureBus& sensors,
+    Acquisition& acquisition,
+    const Calibration& calibration,
+    SlotTable& hot,
+    Switches& switches
+)
+:
+    slot_(slot),
+    channel_(slot),
+    sampler_(Profile::board::overSampling),
+    calibration_(calibration),
+    switches_(switches),
+    emptyQ4_(0),
+    cutOffQ4_(0),
+    fullQ4_(0),
+    nU_(0),
+    nTotalDischarges_(nDischargeCycles),
+    nDischarges_(0),
+    tOld_(0),
+    t_(0),
+    tOffset_(tOffset),
+    tStart_(tOffset),
+    P_(0),
+    CAve_(0),
+    eAve_(0),
+    CStart_(0),
+    eStart_(0),
+    repeat_(false),
+    endOfCharge_
+    (
+        Profile::cell::eocWindow,
+        Profile::UFull,
+        Profile::cell::eocSlopeMax,
+        Profile::cell::eocSdMax,
+        Profile::cell::eocDropMin,
+        Profile::cell::eocTimeout
+    ),
+    screen_
+    (
+        Profile::cell::screenSettle,
+        Profile::cell::screenPulse,
+        Profile::cell::screenRecover,
+        Profile::cell::screenUMin,
+        Profile::cell::screenRMax,
+        Profile::cell::screenDURecovery,
+        Profile::board::RLoad
+    ),
+    TLow_(Profile::cell::TMax),
+    THigh_(Profile::cell::TMin),
+    TSensorAddress_{0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0},
+    sensors_(sensors),
+    hot_(hot),
+    writeInterval_(writeInterval),
+    door_(Profile::cell::logError, 1000*writeInterval),
+    record_{0, 0, 0, 0, 0, 0}
+{
+    snprintf
+    (
+        hot_.fileName[slot_],
+        sizeof(hot_.fileName[slot_]),
+        "slot_%d",
+        slot_
+    );
+
+    hot_.mode[slot_] = uint8_t(Battery::EMPTY);
+    hot_.T[slot_] = 0;
+
+    reset();
+    setThresholds();
+
+    sensors_.attach(slot_, TSensorAddress_);
+    acquisition.attach(channel_, sampler_);
+}
+
+
+template<class Profile>
+Battery<Profile>::~Battery()
+{}
+
+
+// * * * * * * * * * * * Public Setter Functions * * * * * * * * * * * * * * //
+
+template<class Profile>
+void Battery<Profile>::setOffset(const unsigned long tOffset)
+{
+    tOffset_ = tOffset;
+    t_ = 0;
+    tOld_ = 0;
+}
+
+
+template<class Profile>
+void Battery<Profile>::setU(const float U)
+{
+    hot_.U[slot_] = U;
+}
+
+
+template<class Profile>
+void Battery<Profile>::setU()
+{
+    hot_.U[slot_] = readU();
+}
+
+
+template<class Profile>
+void Battery<Profile>::setI(const float I)
+{
+    hot_.I[slot_] = int32_t(I*1000);
+}
+
+
+template<class Profile>
+void Battery<Profile>::setMode(const enum mode m)
+{
+    // The records of the previous phase end here
+    closeSeries();
+
+    hot_.mode[slot_] = uint8_t(m);
+
+    if (mode() == Battery::CHARGE)
+    {
+        switches_.charge(slot_, true);
+        endOfCharge_.reset();
+    }
+    else if (mode() == Battery::DISCHARGE)
+    {
+        switches_.charge(slot_, false);
+
+        // A repeated discharge starts from the integrals of the paused one
+        if (repeat_)
+        {
+            hot_.C[slot_].restore(CStart_);
+            hot_.e[slot_].restore(eStart_);
+            repeat_ = false;
+        }
+        else
+        {
+            CStart_ = hot_.C[slot_].sum();
+            eStart_ = hot_.e[slot_].sum();
+        }
+    }
+    else if (mode() == Battery::EMPTY || mode() == Battery::WAIT)
+    {
+        switches_.charge(slot_, true);
+    }
+    else if (mode() == Battery::SCREEN)
+    {
+        switches_.charge(slot_, true);
+        screen_.reset();
+        repeat_ = false;
+        tStart_ = hal().millis();
+        TLow_ = Profile::cell::TMax;
+        THigh_ = Profile::cell::TMin;
+    }
+}
+
+
+template<class Profile>
+void Battery<Profile>::setThresholds()
+{
+    emptyQ4_ = calibration_.countsQ4(slot_, Profile::UEmpty);
+    cutOffQ4_ = calibration_.countsQ4(slot_, Profile::UCutOff);
+    fullQ4_ = calibration_.countsQ4(slot_, Profile::UFull);
+}
+
+
+template<class Profile>
+void Battery<Profile>::setTSensorAddress(const unsigned int i, const byte b)
+{
+    TSensorAddress_[i] = b;
+}
+
+
+// * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * * //
+
+template<class Profile>
+bool Battery<Profile>::checkIfReplacedOrEmpty()
+{
+    // Check if slot is empty (raw ADC counts below the empty voltage)
+    if (below(emptyQ4_))
+    {
+        setMode(Battery::EMPTY);
+        reset();
+        return true;
+    }
+    else
+    {
+        // Check if the state was empty, if so, set to first and return true
+        if (mode() == Battery::EMPTY)
+        {
+            setMode(Battery::FIRST);
+
+            // It was replaced
+            return true;
+        }
+
+        // It was not replaced and previously not empty
+        return false;
+    }
+
+    // TODO: might be optimized
+    // Check if current U at A0 is around the last measurement
+    // point +- 50 mV, or if we are < 2.4 V its a new one
+    /*if (U < 2.4)
+    {
+        return true;
+    }
+
+    if
+    (
+        (U > (hot_.U[slot_] - 0.05) && U < (hot_.U[slot_] + 0.051))
+    )
+    {
+        return false;
+    }
+    else
+    {
+        return true;
+    }*/
+}
+
+
+template<class Profile>
+void Battery<Profile>::incrementDischarges()
+{
+    ++nDischarges_;
+}
+
+
+template<class Profile>
+void Battery<Profile>::reset()
+{
+    // Before resetting, take the last values for averaging process
+    // We devide this data after we are finished by nCycles
+    CAve_ += C();
+    eAve_ += e();
+
+    // Reset all data
+    tOld_ = 0;
+    t_ = 0;
+    tOffset_ = t_;
+    hot_.U[slot_] = 0;
+    hot_.I[slot_] = 0;
+    P_ = 0;
+    hot_.C[slot_].reset();
+    hot_.e[slot_].reset();
+}
+
+
+template<class Profile>
+void Battery<Profile>::pause()
+{
+    closeSeries();
+
+    LOGW
+    (
+        " +++ DISCHARGE PAUSED (T = " << Format::Fixed(T(), 1)
+        << ", t = " << t_/1000 << " s) +++ " << endl
+    );
+
+    // Add horizontal line to file
+    WriterReader::insertHorizontalLineToFile(fileName());
+
+    // A discharge shorter than the window of the end-of-charge detection
+    // took out a few mAh only, the charger tops the cell up while it waits
+    // (the detector would not see the short CV phase). Otherwise the cell
+    // is charged again
+    const bool full = t_ < 1000ul*Profile::cell::eocWindow;
+
+    // The data of the stopped discharge do not count
+    hot_.C[slot_].restore(CStart_);
+    hot_.e[slot_].restore(eStart_);
+    repeat_ = true;
+    setMode(full ? Battery::WAIT : Battery::CHARGE);
+}
+
+
+template<class Profile>
+void Battery<Profile>::update()
+{
+    // Update the actual voltage - we do it for both modes
+    // + charging
+    // + discharging
+    setU();
+
+    // From here on integers only (from the raw ADC counts), floats are
+    // produced when reporting
+    const int64_t UmV = readmV();
+
+    // Calculate the current (uA)
+    hot_.I[slot_] = int32_t((UmV*Profile::G) >> 16);
+
+    // Calculate the current dissipation (nW)
+    P_ = UmV*hot_.I[slot_];
+
+    // Update the time (ms)
+    tOld_ = t_;
+    t_ = hal().millis() - tOffset_;
+    const uint32_t dt = t_ - tOld_;
+
+    // Integrate the capacity and the energy (trapezoidal rule)
+    hot_.C[slot_].add(dt, hot_.I[slot_]);
+    hot_.e[slot_].add(dt, P_);
+}
+
+
+template<class Profile>
+void Battery<Profile>::log()
+{
+    // The records of a quiet slot are committed after the maximum age
+    WriterReader::flushExpired(fileName());
+
+    // Only charging and discharging data are of interest
+    if (mode() != Battery::CHARGE && mode() != Battery::DISCHARGE)
+    {
+        return;
+    }
+
+    // No update of the phase yet
+    if (!t_)
+    {
+        return;
+    }
+
+    const float record[] = { t_/float(1000), U(), I(), P(), C(), e() };
+
+    // Voltage and current are compressed
+    switch (door_.add(t_, record + 1))
+    {
+        case SwingingDoor::PREVIOUS:
+            write(record_);
+            break;
+
+        case SwingingDoor::CURRENT:
+            write(record);
+            break;
+
+        default:
+            break;
+    }
+
+    memcpy(record_, record, sizeof(record_));
+}
+
+
+template<class Profile>
+Checkpoint Battery<Profile>::checkpoint() const
+{
+    Checkpoint c;
+
+    c.slot = uint8_t(slot_);
+    c.mode = uint8_t(mode());
+    c.nDischarges = uint16_t(nDischarges_);
+    c.t = t_;
+    c.U = uint16_t(constrain(hot_.U[slot_], 0.f, 65.f)*1000);
+    c.C = hot_.C[slot_].sum();
+    c.e = hot_.e[slot_].sum();
+    c.CStart = CStart_;
+    c.eStart = eStart_;
+    c.repeat = repeat_;
+    c.CAve = CAve_;
+    c.eAve = eAve_;
+
+    return c;
+}
+
+
+template<class Profile>
+CatalogEntry Battery<Profile>::catalogEntry() const
+{
+    return
+        Catalog::entry
+        (
+            cellID(),
+            uint8_t(slot_),
+            mode() == Battery::FAILED ? Catalog::FAILED : Catalog::TESTED,
+            uint16_t(nDischarges_),
+            readU(),
+            TLow_,
+            THigh_,
+            CAve_,
+            eAve_
+        );
+}
+
+
+template<class Profile>
+bool Battery<Profile>::resume(const Checkpoint& c)
+{
+    const enum mode m = static_cast<enum mode>(c.mode);
+
+    // Only tests in progress or finished tests are resumed
+    if
+    (
+        m != Battery::SCREEN
+     && m != Battery::CHARGE
+     && m != Battery::DISCHARGE
+     && m != Battery::TESTED
+     && m != Battery::FAILED
+     && m != Battery::WAIT
+    )
+    {
+        return false;
+    }
+
+    // The phase of the checkpoint has to be a running one: a charge ends
+    // at the latest at the timeout of the end-of-charge detection, a
+    // discharge at the cut-off voltage
+    if
+    (
+        (
+            m == Battery::CHARGE
+         && c.t > 60000ul*Profile::cell::eocTimeout
+        )
+     || (
+            m == Battery::DISCHARGE
+         && c.U < Profile::UCutOff
+        )
+    )
+    {
+        return false;
+    }
+
+    // The cell in the slot has to be the one of the checkpoint (the
+    // voltage jumps by the switched current times Ri after the reset),
+    // otherwise it is tested anew
+    const float U = readU();
+
+    if (abs(U - c.U/1000.f) > 0.3)
+    {
+        return false;
+    }
+
+    nDischarges_ = c.nDischarges;
+    CAve_ = c.CAve;
+    eAve_ = c.eAve;
+
+    setMode(m);
+
+    // Continue the phase at the time of the checkpoint
+    if (m == Battery::SCREEN)
+    {
+        setOffset(hal().millis());
+    }
+    else
+    {
+        tOffset_ = hal().millis() - c.t;
+        t_ = c.t;
+        tOld_ = c.t;
+        hot_.C[slot_].restore(c.C);
+        hot_.e[slot_].restore(c.e);
+        CStart_ = c.CStart;
+        eStart_ = c.eStart;
+        repeat_ = c.repeat;
+
+        // The journal does not keep the start of the test, the summary
+        // starts with the resumed phase
+        tStart_ = tOffset_;
+    }
+
+    hot_.U[slot_] = U;
+
+    return true;
+}
+
+
+template<class Profile>
+bool Battery<Profile>::screening()
+{
+    const FastScreen::result r =
+        screen_.update(hal().millis() - tOffset_, readU());
+
+    // Discharge pulse
+    switches_.charge(slot_, !screen_.load());
+
+    if (r == FastScreen::RUNNING)
+    {
+        return true;
+    }
+
+    LOGI
+    (
+        " ++ Fast screen: " << FastScreen::name(r) << " (R = "
+        << Format::Fixed(screen_.R(), 3) << " Ohm)" << endl
+    );
+
+    if (r != FastScreen::PASSED)
+    {
+        LOGW(" +++ CELL REJECTED +++ " << endl);
+        setMode(Battery::FAILED);
+    }
+
+    return false;
+}
+
+
+template<class Profile>
+bool Battery<Profile>::charging()
+{
+    // Sliding window detection of the charger termination (O(1) per call)
+    const EndOfCharge::reason r = endOfCharge_.update(t_, hot_.U[slot_]);
+
+    if (r == EndOfCharge::NONE)
+    {
+        return true;
+    }
+
+    closeSeries();
+
+    LOGI
+    (
+        " ++ Charging finished: " << EndOfCharge::name(r) << " (slope "
+        << Format::Fixed(endOfCharge_.slope(), 2) << " mV/min, sd "
+        << Format::Fixed(endOfCharge_.sd(), 2) << " mV)" << endl
+    );
+
+    // Add horizontal line to file
+    WriterReader::insertHorizontalLineToFile(fileName());
+
+    return false;
+}
+
+
+template<class Profile>
+bool Battery<Profile>::discharging()
+{
+    // If the voltage is lower than the cut-off voltage we stop discharging
+    // (raw ADC counts)
+    if (below(cutOffQ4_))
+    {
+        closeSeries();
+
+        // Add horizontal line to file
+        WriterReader::insertHorizontalLineToFile(fileName());
+
+        return false;
+    }
+    // Still discharging
+    else
+    {
+        return true;
+    }
+}
+
+
+template<class Profile>
+bool Battery<Profile>::checkIfFullyTested() const
+{
+    if (nDischarges_ == nTotalDischarges_)
+    {
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+
+template<class Profile>
+bool Battery<Profile>::temperatureRangeOkay()
+{
+    LOGD(" ++ Check temperature range" << endl);
+    // FIrst make an temperature update
+    const float T = readT();
+    hot_.T[slot_] = T;
+
+    LOGD(" ++ T = " << Format::Fixed(T, 2) << endl);
+
+    // Handle error codes
+    if (T == 85 || T == -127)
+    {
+        return false;
+    }
+
+    // Extremes of the test
+    if (T < TLow_)
+    {
+        TLow_ = T;
+    }
+
+    if (T > THigh_)
+    {
+        THigh_ = T;
+    }
+
+    // User defined bounds
+    if (T < Profile::cell::TMin || T > Profile::cell::TMax)
+    {
+        return false;
+    }
+    else
+    {
+        return true;
+    }
+}
+
+
+template<class Profile>
+void Battery<Profile>::correctAverageData()
+{
+    CAve_ /= float(nDischarges_);
+    eAve_ /= float(nDischarges_);
+}
+
+
+// * * * * * * * * * * * Public IO Member Functions  * * * * * * * * * * * * //
+
+template<class Profile>
+void Battery<Profile>::removeDataFile()
+{
+    WriterReader::removeDataFile(fileName());
+}
+
+
+template<class Profile>
+bool Battery<Profile>::showDataFileContent(LogReader& reader)
+{
+    return WriterReader::showDataFileContent(fileName(), reader);
+}
+
+
+template<class Profile>
+void Battery<Profile>::addFinalDataToFile()
+{
+    WriterReader::addFinalDataToFile
+    (
+        fileName(),
+        nDischarges_,
+        readU(),
+        CAve_,
+        eAve_,
+        tStart_
+    );
+}
+
+
+template<class Profile>
+bool Battery<Profile>::finalized()
+{
+    return WriterReader::finalized(fileName());
+}
+
+
+template<class Profile>
+void Battery<Profile>::flush()
+{
+    WriterReader::flush(fileName());
+}
+
+
+template<class Profile>
+void Battery<Profile>::updateFileName() const
+{
+    WriterReader::updateFileName(fileName());
+}
+
+
+// * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * * //
+
+template<class Profile>
+void Battery<Profile>::write(const float* r)
+{
+    writeData(fileName(), r[0], r[1], r[2], r[3], r[4], r[5]);
+}
+
+
+template<class Profile>
+void Battery<Profile>::closeSeries()
+{
+    if (door_.pending())
+    {
+        write(record_);
+    }
+
+    door_.reset();
+}
+
+
+template<class Profile>
+float Battery<Profile>::readU() const
+{
+    // The sampler holds the mean of the last samples (taken every 10 ms),
+    // hence nothing to wait for here
+    return readmV()/1000.f;
+}
+
+
+template<class Profile>
+bool Battery<Profile>::below(const uint32_t thresholdQ4) const
+{
+    // sum/n < threshold, compared in integers
+    return
+        !sampler_.n()
+     || (sampler_.sum() << 4) < thresholdQ4*sampler_.n();
+}
+
+
+template<class Profile>
+int32_t Battery<Profile>::readmV() const
+{
+    if (!sampler_.n())
+    {
+        return 0;
+    }
+
+    return calibration_.mV(slot_, readCountsQ4());
+}
+
+
+template<class Profile>
+uint32_t Battery<Profile>::readCountsQ4() const
+{
+    // As many of the latest samples as the noise needs for the target
+    // error, the trimmed mean drops two of them
+    unsigned int k =
+        sampler_.needed(Profile::sigmaQ4, Profile::board::overSamplingMin)
+      + (Profile::board::trim ? 2 : 0);
+
+    uint32_t c = sampler_.meanQ4(k, Profile::board::trim);
+
+    // Full accuracy close to the decisions
+    if (k < sampler_.n() && nearLimit(c))
+    {
+        k = sampler_.n();
+        c = sampler_.meanQ4(k, Profile::board::trim);
+    }
+
+    nU_ = k < sampler_.n() ? k : sampler_.n();
+
+    return c;
+}
+
+
+template<class Profile>
+bool Battery<Profile>::nearLimit(const uint32_t c) const
+{
+    const uint32_t limits[] = { emptyQ4_, cutOffQ4_, fullQ4_ };
+
+    for (const uint32_t l : limits)
+    {
+        if (c + Profile::guardQ4 > l && c < l + Profile::guardQ4)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template<class Profile>
+float Battery<Profile>::readT() const
+{
+    return sensors_.T(slot_);
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,175 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Power and thermal budget of the bench. Each slot has an expected power
+    per mode: a charging cell draws the power of its charger module from
+    the supply, a discharging cell heats its load resistor (U^2/R at the
+    full voltage). The budget sweeps the hot data of all slots (mode and
+    temperature, see slotTable.h) and admits a new discharge only if the
+    total power stays within the budget of the bench and the cell has
+    thermal headroom below TMax. At least one discharge is always admitted,
+    even if the charging slots alone exceed the budget, hence a budget
+    below one discharge never stalls the bench.
+
+    The waiting slots are admitted in the order they started to wait, a
+    slot that lacks thermal headroom lets the next one go first. A
+    discharge resumed after a reset is admitted like a new one.
+
+    A slot only switches between the charger and the load resistor, there
+    is no open circuit state. Hence the charge phases are not admitted by
+    the budget (a slot cannot wait without its charger), they only count
+    in the load. A discharge that gets close to TMax is paused by charging
+    the cell again; the discharge is repeated from the full cell when it
+    is admitted again. A cell that is paused too often is treated as
+    before (it fails at TMax).
+
+    The class template reads the modes of the Battery class template Cell.
+
+SourceFiles
+    budgetI.h
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef budget_h
+#define budget_h
+
+#include <Arduino.h>
+#include "../slotTable/slotTable.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Budget Declaration
+\*---------------------------------------------------------------------------*/
+
+template<class Cell>
+class Budget
+{
+public:
+
+    // Maximum number of slots (16 channel multiplexer)
+    static const unsigned int nMax = SlotTable::nMax;
+
+
+private:
+
+    // Private class data
+
+        // Hot data of all slots
+        const SlotTable& hot_;
+
+        // Number of slots
+        unsigned int n_;
+
+        // Power budget of the bench, expected power of a charging and of a
+        // discharging slot (mW)
+        uint32_t PMax_;
+        uint32_t PCharge_;
+        uint32_t PDischarge_;
+
+        // A discharge pauses at TPause_, it starts below TStart_ (dC)
+        float TPause_;
+        float TStart_;
+
+        // Maximum number of pauses of a cell
+        unsigned int nPausesMax_;
+
+        // Start of the waiting (ms) and number of pauses of each slot
+        unsigned long tWait_[nMax];
+        uint8_t pauses_[nMax];
+
+
+        // Statistics
+
+            // Admitted discharges, their total waiting time (s) and pauses
+            unsigned long admitted_;
+            unsigned long tWaited_;
+            unsigned long paused_;
+
+            // Highest expected power of the bench (mW)
+            uint32_t PPeak_;
+
+
+    // Private Member Functions
+
+        // Return the expected power of the slot in its mode (mW)
+        uint32_t P(const unsigned int) const;
+
+        // Return true if the slot has thermal headroom for a discharge
+        inline bool cool(const unsigned int slot) const
+        {
+            return hot_.T[slot] < TStart_;
+        }
+
+
+public:
+
+    // Constructor (hot data, number of slots, budget of the bench, power
+    // of a charging and a discharging slot (W), TMax, margin of the pause
+    // below TMax (dC), maximum number of pauses)
+    Budget
+    (
+        const SlotTable&,
+        const unsigned int,
+        const float,
+        const float,
+        const float,
+        const float,
+        const float,
+        const unsigned int
+    );
+
+    // Destructor
+    ~Budget();
+
+
+    // Public Return Functions
+
+        // Return the expected power of all slots (mW)
+        uint32_t load() const;
+
+        // Return true if the discharging slot is close to TMax
+        inline bool hot(const unsigned int slot) const
+        {
+            return hot_.T[slot] >= TPause_;
+        }
+
+
+    // Public Member Functions
+
+        // The slot starts to wait for its discharge
+        void wait(const unsigned int);
+
+        // Return true if the waiting slot may start its discharge now
+        bool admit(const unsigned int);
+
+        // Return true if the hot slot may pause (false if it paused too
+        // often)
+        bool pause(const unsigned int);
+
+        // A new cell is in the slot
+        void clear(const unsigned int);
+
+        // Print the statistics
+        void report(Print&) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#include "budgetI.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
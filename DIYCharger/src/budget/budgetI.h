@@ -0,0 +1,201 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "../hal/hal.h"
+#include "../format/format.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+template<class Cell>
+const unsigned int Budget<Cell>::nMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+template<class Cell>
+Budget<Cell>::Budget
+(
+    const SlotTable& hot,
+    const unsigned int nSlots,
+    const float PMax,
+    const float PCharge,
+    const float PDischarge,
+    const float TMax,
+    const float TMargin,
+    const unsigned int nPausesMax
+)
+:
+    hot_(hot),
+    n_(nSlots < nMax ? nSlots : nMax),
+    PMax_(uint32_t(PMax*1000)),
+    PCharge_(uint32_t(PCharge*1000)),
+    PDischarge_(uint32_t(PDischarge*1000)),
+    TPause_(TMax - TMargin),
+    TStart_(TMax - 2*TMargin),
+    nPausesMax_(nPausesMax),
+    admitted_(0),
+    tWaited_(0),
+    paused_(0),
+    PPeak_(0)
+{
+    for (unsigned int i = 0; i < nMax; ++i)
+    {
+        tWait_[i] = 0;
+        pauses_[i] = 0;
+    }
+}
+
+
+template<class Cell>
+Budget<Cell>::~Budget()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+template<class Cell>
+uint32_t Budget<Cell>::P(const unsigned int slot) const
+{
+    switch (hot_.mode[slot])
+    {
+        case Cell::CHARGE:
+        case Cell::SCREEN:
+            return PCharge_;
+
+        case Cell::DISCHARGE:
+            return PDischarge_;
+
+        default:
+            return 0;
+    }
+}
+
+
+// * * * * * * * * * * * * Public Return Functions * * * * * * * * * * * * * //
+
+template<class Cell>
+uint32_t Budget<Cell>::load() const
+{
+    uint32_t PTotal = 0;
+
+    for (unsigned int slot = 0; slot < n_; ++slot)
+    {
+        PTotal += P(slot);
+    }
+
+    return PTotal;
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+template<class Cell>
+void Budget<Cell>::wait(const unsigned int slot)
+{
+    tWait_[slot] = hal().millis();
+}
+
+
+template<class Cell>
+bool Budget<Cell>::admit(const unsigned int slot)
+{
+    if (!cool(slot))
+    {
+        return false;
+    }
+
+    // One sweep over the hot data: the load of the bench, the running
+    // discharges and the slots that wait longer (and may start)
+    uint32_t PTotal = 0;
+    bool discharging = false;
+
+    for (unsigned int i = 0; i < n_; ++i)
+    {
+        // The slot itself waits or resumes its discharge after a reset
+        if (i == slot)
+        {
+            continue;
+        }
+
+        PTotal += P(i);
+
+        if (hot_.mode[i] == Cell::DISCHARGE)
+        {
+            discharging = true;
+        }
+        else if
+        (
+            hot_.mode[i] == Cell::WAIT
+         && int32_t(tWait_[slot] - tWait_[i]) > 0
+         && cool(i)
+        )
+        {
+            return false;
+        }
+    }
+
+    // The charges cannot be held back (no open circuit state), if they
+    // alone exceed the budget the first discharge starts anyway, the bench
+    // would never discharge otherwise
+    if (discharging && PTotal + PDischarge_ > PMax_)
+    {
+        return false;
+    }
+
+    ++admitted_;
+    tWaited_ += (hal().millis() - tWait_[slot])/1000;
+
+    if (PTotal + PDischarge_ > PPeak_)
+    {
+        PPeak_ = PTotal + PDischarge_;
+    }
+
+    return true;
+}
+
+
+template<class Cell>
+bool Budget<Cell>::pause(const unsigned int slot)
+{
+    if (pauses_[slot] >= nPausesMax_)
+    {
+        return false;
+    }
+
+    ++pauses_[slot];
+    ++paused_;
+
+    return true;
+}
+
+
+template<class Cell>
+void Budget<Cell>::clear(const unsigned int slot)
+{
+    pauses_[slot] = 0;
+}
+
+
+template<class Cell>
+void Budget<Cell>::report(Print& out) const
+{
+    out << "# Budget (W): " << Format::Fixed(PMax_/1000.f, 1)
+        << ", peak: " << Format::Fixed(PPeak_/1000.f, 1)
+        << ", discharges: " << admitted_
+        << ", waited (s): " << tWaited_
+        << ", paused: " << paused_ << endl;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,322 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "calibration.h"
+#include "../log/log.h"
+#include "../record/record.h"
+#include "../format/format.h"
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Calibration::Calibration(const int64_t mVPerCountQ16)
+:
+    name_("calibration"),
+    mVPerCountQ16_(mVPerCountQ16),
+    refSlot_(-1),
+    nRef_(0)
+{
+    for (unsigned int slot = 0; slot < nSlotsMax; ++slot)
+    {
+        setLinear(slot);
+    }
+}
+
+
+Calibration::~Calibration()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+bool Calibration::valid(const CalibrationRecord& r)
+{
+    return
+        r.slot < nSlotsMax
+     && Record::valid(r);
+}
+
+
+void Calibration::set
+(
+    const int slot,
+    const uint16_t* knots,
+    const uint8_t nReferences
+)
+{
+    for (unsigned int k = 0; k < nKnots; ++k)
+    {
+        mV_[slot][k] = knots[k];
+    }
+
+    for (unsigned int k = 0; k < nSegments; ++k)
+    {
+        rise_[slot][k] = int16_t(int32_t(knots[k + 1]) - knots[k]);
+    }
+
+    nReferences_[slot] = nReferences;
+}
+
+
+void Calibration::setLinear(const int slot)
+{
+    uint16_t knots[nKnots];
+
+    for (unsigned int k = 0; k < nKnots; ++k)
+    {
+        const int64_t counts = int64_t(k) << segmentShift;
+        const int64_t v = (counts*mVPerCountQ16_ + 32768) >> 16;
+
+        knots[k] = v > 0xFFFF ? 0xFFFF : uint16_t(v);
+    }
+
+    set(slot, knots, 0);
+}
+
+
+// * * * * * * * * * * * * * Public Return Functions * * * * * * * * * * * * //
+
+uint32_t Calibration::countsQ4(const int slot, const int32_t mV) const
+{
+    const unsigned int shift = segmentShift + 4;
+
+    // First segment which ends above the voltage (the last one otherwise)
+    unsigned int k = 0;
+
+    while (k < nSegments - 1 && mV_[slot][k + 1] <= mV)
+    {
+        ++k;
+    }
+
+    const int32_t base = int32_t(k << shift);
+
+    if (rise_[slot][k] <= 0)
+    {
+        return base;
+    }
+
+    const int32_t c =
+        base + ((mV - mV_[slot][k])*(int32_t(1) << shift))/rise_[slot][k];
+
+    return c > 0 ? uint32_t(c) : 0;
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+bool Calibration::load()
+{
+    bool success = false;
+
+    if (startFS())
+    {
+        if (fileExist(name_))
+        {
+            File f = openFile(name_);
+            CalibrationRecord r;
+
+            success = true;
+
+            while
+            (
+                f.read(reinterpret_cast<uint8_t*>(&r), sizeof(r)) == sizeof(r)
+            )
+            {
+                if (!valid(r))
+                {
+                    LOGE("ERROR: File '" << name_ << "' has a bad record" << endl);
+                    success = false;
+                }
+                else if (r.nReferences)
+                {
+                    uint16_t knots[nKnots];
+                    memcpy(knots, r.mV, sizeof(knots));
+
+                    set(r.slot, knots, r.nReferences);
+
+                    LOGI
+                    (
+                        " ++ Calibration of slot #" << int(r.slot)
+                        << " loaded (" << int(r.nReferences) << " references)"
+                        << endl
+                    );
+                }
+            }
+
+            f.close();
+        }
+
+        stopFS();
+    }
+
+    return success;
+}
+
+
+bool Calibration::addReference
+(
+    const int slot,
+    const uint32_t countsQ4,
+    const uint16_t mV
+)
+{
+    if (slot < 0 || slot >= int(nSlotsMax))
+    {
+        return false;
+    }
+
+    if (slot != refSlot_)
+    {
+        refSlot_ = slot;
+        nRef_ = 0;
+    }
+
+    // Keep the points sorted by the reading, the same reading replaces
+    // the older point
+    unsigned int i = 0;
+
+    while (i < nRef_ && refCountsQ4_[i] < countsQ4)
+    {
+        ++i;
+    }
+
+    if (i < nRef_ && refCountsQ4_[i] == countsQ4)
+    {
+        refmV_[i] = mV;
+        return true;
+    }
+
+    if (nRef_ == nReferencesMax)
+    {
+        LOGW("Calibration: too many references for slot #" << slot << endl);
+        return false;
+    }
+
+    for (unsigned int j = nRef_; j > i; --j)
+    {
+        refCountsQ4_[j] = refCountsQ4_[j - 1];
+        refmV_[j] = refmV_[j - 1];
+    }
+
+    refCountsQ4_[i] = countsQ4;
+    refmV_[i] = mV;
+    ++nRef_;
+
+    return true;
+}
+
+
+bool Calibration::calibrate(const int slot)
+{
+    if (slot != refSlot_ || nRef_ < 2)
+    {
+        LOGW("Calibration: slot #" << slot << " needs two references" << endl);
+        return false;
+    }
+
+    // Interpolate the knots between the reference points, beyond the
+    // first and last point the outer segments are extrapolated
+    uint16_t knots[nKnots];
+    unsigned int i = 0;
+
+    for (unsigned int k = 0; k < nKnots; ++k)
+    {
+        const int64_t x = int64_t(k) << (segmentShift + 4);
+
+        while (i + 2 < nRef_ && refCountsQ4_[i + 1] <= x)
+        {
+            ++i;
+        }
+
+        const int64_t x0 = refCountsQ4_[i];
+        const int64_t y0 = refmV_[i];
+        const int64_t dx = int64_t(refCountsQ4_[i + 1]) - x0;
+        const int64_t dy = int64_t(refmV_[i + 1]) - y0;
+        const int64_t v = y0 + (dy*(x - x0))/dx;
+
+        knots[k] = v < 0 ? 0 : (v > 0xFFFF ? 0xFFFF : uint16_t(v));
+
+        if (k && knots[k] < knots[k - 1])
+        {
+            LOGE
+            (
+                "ERROR: Calibration of slot #" << slot << " not monotonic"
+                << endl
+            );
+            return false;
+        }
+    }
+
+    set(slot, knots, uint8_t(nRef_));
+    nRef_ = 0;
+
+    // Save all tables, the new file replaces the old one at once
+    bool success = false;
+
+    if (startFS())
+    {
+        File f = beginReplace(name_);
+        success = bool(f);
+
+        for (unsigned int s = 0; success && s < nSlotsMax; ++s)
+        {
+            if (!nReferences_[s])
+            {
+                continue;
+            }
+
+            CalibrationRecord r;
+
+            for (unsigned int k = 0; k < nKnots; ++k)
+            {
+                r.mV[k] = mV_[s][k];
+            }
+
+            r.slot = uint8_t(s);
+            r.nReferences = nReferences_[s];
+            Record::seal(r);
+
+            success =
+                f.write(reinterpret_cast<const uint8_t*>(&r), sizeof(r))
+             == sizeof(r);
+        }
+
+        if (!endReplace(name_, f, success))
+        {
+            LOGE("ERROR: File '" << name_ << "' not written" << endl);
+        }
+
+        stopFS();
+    }
+
+    return success;
+}
+
+
+void Calibration::print(Print& out, const int slot) const
+{
+    out.print("# Calibration of slot ");
+    Format::integer(out, slot);
+    out.print(nReferences_[slot] ? "\n" : " (linear default)\n");
+
+    for (unsigned int k = 0; k < nKnots; ++k)
+    {
+        Format::integer(out, k << segmentShift);
+        out.print("\t");
+        Format::integer(out, mV_[slot][k]);
+        out.print(" mV\n");
+    }
+}
+
+
+// ************************************************************************* //
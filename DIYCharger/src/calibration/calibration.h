@@ -0,0 +1,182 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Per-slot calibration of the ADC. The ESP8266 ADC is not linear near both
+    ends of its range and each slot has its own voltage divider, hence each
+    slot gets a piecewise-linear mapping from the raw counts to mV. The
+    range of 1024 counts is split into 16 segments of 64 counts; the table
+    holds the voltage at the 17 knots and the precomputed rise of each
+    segment. As the segments have a width of a power of two, the lookup is
+    O(1) with a shift and a multiplication, without any division.
+
+    The tables are loaded once at boot from the flash. Without a valid
+    table, a slot uses the linear characteristic of the board profile.
+
+    Calibration of a slot: apply known reference voltages to the slot, add
+    the actual reading for each of them as reference point (at least two,
+    spread over the range) and fit the table. The knots are interpolated
+    linearly between the reference points (extrapolated beyond them) and
+    saved to the flash.
+
+SourceFiles
+    calibration.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef calibration_h
+#define calibration_h
+
+#include "../filesystem/filesystem.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                     Struct CalibrationRecord Declaration
+\*---------------------------------------------------------------------------*/
+
+struct __attribute__((packed)) CalibrationRecord
+{
+    // Voltage at the knots (mV)
+    uint16_t mV[17];
+
+    // Slot of the table and number of reference points of the fit
+    uint8_t slot;
+    uint8_t nReferences;
+
+    // CRC-16 of all fields above
+    uint16_t crc;
+};
+
+
+/*---------------------------------------------------------------------------*\
+                         Class Calibration Declaration
+\*---------------------------------------------------------------------------*/
+
+class Calibration
+:
+    public FileSystem
+{
+public:
+
+    // Maximum number of slots (16 channel multiplexer)
+    static const unsigned int nSlotsMax = 16;
+
+    // Number of segments and width of a segment (1 << shift counts)
+    static const unsigned int nSegments = 16;
+    static const unsigned int segmentShift = 6;
+
+    // Number of knots of the table
+    static const unsigned int nKnots = nSegments + 1;
+
+    // Maximum number of reference points of a calibration
+    static const unsigned int nReferencesMax = 8;
+
+
+private:
+
+    // Private class data
+
+        // File name of the tables
+        const char* const name_;
+
+        // Voltage of one ADC count of the linear default (mV, Q16)
+        const int64_t mVPerCountQ16_;
+
+        // Voltage at the knots (mV) and rise of the segments (mV)
+        uint16_t mV_[nSlotsMax][nKnots];
+        int16_t rise_[nSlotsMax][nSegments];
+
+        // Number of reference points of the table (0: linear default)
+        uint8_t nReferences_[nSlotsMax];
+
+        // Reference points of the running calibration: slot, readings
+        // (1/16 counts) and voltages (mV)
+        int refSlot_;
+        uint32_t refCountsQ4_[nReferencesMax];
+        uint16_t refmV_[nReferencesMax];
+        unsigned int nRef_;
+
+
+    // Private Member Functions
+
+        // Return true if the record is valid
+        static bool valid(const CalibrationRecord&);
+
+        // Set the knots of the slot and precompute the rise of the segments
+        void set(const int, const uint16_t*, const uint8_t);
+
+        // Set the linear default of the board
+        void setLinear(const int);
+
+
+public:
+
+    // Constructor (voltage of one ADC count (mV, Q16) of the board)
+    explicit Calibration(const int64_t);
+
+    // Destructor
+    ~Calibration();
+
+
+    // Public Return Functions
+
+        // Return true if the slot has a calibrated table
+        inline bool calibrated(const int slot) const
+        {
+            return nReferences_[slot];
+        }
+
+        // Return the voltage (mV) of the averaged reading (1/16 counts)
+        inline int32_t mV(const int slot, const uint32_t countsQ4) const
+        {
+            // Segment and position within the segment (1/16 counts)
+            const unsigned int shift = segmentShift + 4;
+            unsigned int k = countsQ4 >> shift;
+
+            if (k >= nSegments)
+            {
+                k = nSegments - 1;
+            }
+
+            const int32_t dx = int32_t(countsQ4) - int32_t(k << shift);
+
+            return mV_[slot][k] + ((rise_[slot][k]*dx) >> shift);
+        }
+
+        // Return the reading (1/16 counts) of the voltage (mV), the
+        // inverse of mV() for thresholds (not for the hot path)
+        uint32_t countsQ4(const int, const int32_t) const;
+
+
+    // Public Member Functions
+
+        // Load the tables of all slots from the flash
+        bool load();
+
+        // Add the reading (1/16 counts) of the reference voltage (mV) of
+        // the slot, a reference of another slot starts a new calibration
+        bool addReference(const int, const uint32_t, const uint16_t);
+
+        // Fit the table of the slot to its reference points and save all
+        // tables to the flash
+        bool calibrate(const int);
+
+        // Print the table of the slot
+        void print(Print&, const int) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
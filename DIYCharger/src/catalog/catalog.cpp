@@ -0,0 +1,295 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "catalog.h"
+#include "../log/log.h"
+#include "../record/record.h"
+#include "../format/format.h"
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Catalog::Catalog()
+:
+    name_("catalog")
+{}
+
+
+Catalog::~Catalog()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+bool Catalog::valid(const CatalogEntry& e)
+{
+    return
+        e.status < nStatus
+     && Record::valid(e);
+}
+
+
+bool Catalog::read(File& f, const size_t i, CatalogEntry& e)
+{
+    return
+        f.seek(i*sizeof(CatalogEntry))
+     && f.read(reinterpret_cast<uint8_t*>(&e), sizeof(e)) == sizeof(e)
+     && valid(e);
+}
+
+
+// * * * * * * * * * * * * * Public Static Functions * * * * * * * * * * * * //
+
+CatalogEntry Catalog::entry
+(
+    const uint32_t cellID,
+    const uint8_t slot,
+    const enum status s,
+    const uint16_t nCycles,
+    const float U,
+    const float TMin,
+    const float TMax,
+    const float CAve,
+    const float eAve
+)
+{
+    CatalogEntry e;
+
+    e.cellID = cellID;
+    e.slot = slot;
+    e.status = uint8_t(s);
+    e.nCycles = nCycles;
+    e.U = Record::toFixed(U, 1e3, 0, 0xFFFF);
+    e.TMin = Record::toFixed(TMin, 1e1, -0x8000L, 0x7FFF);
+    e.TMax = Record::toFixed(TMax, 1e1, -0x8000L, 0x7FFF);
+    e.CAve = Record::toFixed(CAve, 1e2, 0, 0x7FFFFFFFL);
+    e.eAve = Record::toFixed(eAve, 1e2, 0, 0x7FFFFFFFL);
+    e.crc = 0;
+
+    return e;
+}
+
+
+const char* Catalog::name(const uint8_t s)
+{
+    static const char* names[nStatus] = { "tested", "failed" };
+
+    return s < nStatus ? names[s] : "unknown";
+}
+
+
+void Catalog::print(Print& out, const CatalogEntry& e)
+{
+    out.print("Cell ");
+    Format::integer(out, e.cellID);
+    out.print(" (slot ");
+    Format::integer(out, e.slot);
+    out.print(", ");
+    out.print(name(e.status));
+    out.print("): C = ");
+    Format::decimal(out, e.CAve, -2, 2);
+    out.print(" mAh, e = ");
+    Format::decimal(out, e.eAve, -2, 2);
+    out.print(" mWh, cycles = ");
+    Format::integer(out, e.nCycles);
+    out.print(", U = ");
+    Format::decimal(out, e.U, -3, 3);
+    out.print(" V, T = ");
+    Format::decimal(out, e.TMin, -1, 1);
+    out.print("..");
+    Format::decimal(out, e.TMax, -1, 1);
+    out.print(" dC\n");
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+bool Catalog::append(CatalogEntry& e)
+{
+    Record::seal(e);
+
+    bool success = false;
+
+    if (startFS())
+    {
+        // Cut a torn record of a reset during the last append
+        if (fileExist(name_))
+        {
+            File f = openFile(name_);
+            const size_t size = f.size();
+            f.close();
+
+            if (size % sizeof(CatalogEntry))
+            {
+                LOGE("ERROR: File '" << name_ << "' has a torn record" << endl);
+
+                // Keep the aligned part only
+                const size_t n = size/sizeof(CatalogEntry);
+                CatalogEntry old;
+
+                File in = openFile(name_);
+                File out = beginReplace(name_);
+
+                for (size_t i = 0; out && i < n; ++i)
+                {
+                    in.read(reinterpret_cast<uint8_t*>(&old), sizeof(old));
+                    out.write(reinterpret_cast<const uint8_t*>(&old), sizeof(old));
+                }
+
+                in.close();
+                endReplace(name_, out, true);
+            }
+        }
+
+        success =
+            FileSystem::writeData
+            (
+                name_,
+                reinterpret_cast<const uint8_t*>(&e),
+                sizeof(e),
+                "a"
+            );
+
+        if (!success)
+        {
+            LOGE("ERROR: File '" << name_ << "' not written" << endl);
+        }
+
+        stopFS();
+    }
+
+    return success;
+}
+
+
+bool Catalog::find(const uint32_t cellID, CatalogEntry& e) const
+{
+    bool success = false;
+
+    if (startFS())
+    {
+        if (fileExist(name_))
+        {
+            File f = openFile(name_);
+            const size_t n = f.size()/sizeof(CatalogEntry);
+
+            CatalogEntry first;
+
+            if (n && read(f, 0, first) && cellID >= first.cellID)
+            {
+                // Direct access, the IDs are consecutive
+                const size_t i = cellID - first.cellID;
+
+                success = i < n && read(f, i, e) && e.cellID == cellID;
+
+                // Binary search, some IDs are missing
+                size_t lo = 0;
+                size_t hi = i < n ? i + 1 : n;
+
+                while (!success && lo < hi)
+                {
+                    const size_t mid = lo + (hi - lo)/2;
+
+                    if (!read(f, mid, e))
+                    {
+                        break;
+                    }
+
+                    if (e.cellID == cellID)
+                    {
+                        success = true;
+                    }
+                    else if (e.cellID < cellID)
+                    {
+                        lo = mid + 1;
+                    }
+                    else
+                    {
+                        hi = mid;
+                    }
+                }
+            }
+
+            f.close();
+        }
+
+        stopFS();
+    }
+
+    return success;
+}
+
+
+unsigned long Catalog::query
+(
+    Print& out,
+    const float CMin,
+    const float CMax
+) const
+{
+    unsigned long nFound = 0;
+
+    if (startFS())
+    {
+        if (fileExist(name_))
+        {
+            File f = openFile(name_);
+
+            const long lo = Record::toFixed(CMin, 1e2, 0, 0x7FFFFFFFL);
+            const long hi = Record::toFixed(CMax, 1e2, 0, 0x7FFFFFFFL);
+
+            CatalogEntry e;
+
+            while
+            (
+                f.read(reinterpret_cast<uint8_t*>(&e), sizeof(e)) == sizeof(e)
+            )
+            {
+                if (valid(e) && long(e.CAve) >= lo && long(e.CAve) <= hi)
+                {
+                    print(out, e);
+                    ++nFound;
+                }
+            }
+
+            f.close();
+        }
+
+        stopFS();
+    }
+
+    return nFound;
+}
+
+
+unsigned long Catalog::size() const
+{
+    unsigned long n = 0;
+
+    if (startFS())
+    {
+        if (fileExist(name_))
+        {
+            File f = openFile(name_);
+            n = f.size()/sizeof(CatalogEntry);
+            f.close();
+        }
+
+        stopFS();
+    }
+
+    return n;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,152 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Append-only catalog of all tested cells. Each finished cell adds one
+    fixed-size binary record (protected by a CRC) with its results, hence
+    the cells can be compared without opening and parsing the measurement
+    files.
+
+    The cell IDs are assigned in increasing order, hence the record of a
+    cell is found directly by its position (ID - ID of the first record).
+    If an ID is missing (e.g., a reset between the assignment and the
+    append), a binary search over the sorted IDs is used instead. A query
+    for a range of the capacity reads the small records sequentially.
+
+SourceFiles
+    catalog.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef catalog_h
+#define catalog_h
+
+#include "../filesystem/filesystem.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                         Struct CatalogEntry Declaration
+\*---------------------------------------------------------------------------*/
+
+struct __attribute__((packed)) CatalogEntry
+{
+    // Running number of the cell
+    uint32_t cellID;
+
+    // Slot in which the cell was tested and the status (see Catalog::status)
+    uint8_t slot;
+    uint8_t status;
+
+    // Number of discharge cycles
+    uint16_t nCycles;
+
+    // Voltage after the last charge (mV)
+    uint16_t U;
+
+    // Minimum and maximum temperature of the cell during the test (0.1 dC)
+    int16_t TMin;
+    int16_t TMax;
+
+    // Average capacity (0.01 mAh) and energy (0.01 mWh)
+    uint32_t CAve;
+    uint32_t eAve;
+
+    // CRC-16 of all fields above
+    uint16_t crc;
+};
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Catalog Declaration
+\*---------------------------------------------------------------------------*/
+
+class Catalog
+:
+    public FileSystem
+{
+public:
+
+    // Result of the test
+    enum status { TESTED, FAILED, nStatus };
+
+
+private:
+
+    // Private class data
+
+        // File name of the catalog
+        const char* const name_;
+
+
+    // Private Member Functions
+
+        // Return true if the record is valid
+        static bool valid(const CatalogEntry&);
+
+        // Read the record at the position, return false if not valid
+        static bool read(File&, const size_t, CatalogEntry&);
+
+
+public:
+
+    // Constructor
+    Catalog();
+
+    // Destructor
+    ~Catalog();
+
+
+    // Public Static Functions
+
+        // Convert the results of a cell into a record
+        static CatalogEntry entry
+        (
+            const uint32_t,
+            const uint8_t,
+            const enum status,
+            const uint16_t,
+            const float,
+            const float,
+            const float,
+            const float,
+            const float
+        );
+
+        // Return the name of the status
+        static const char* name(const uint8_t);
+
+        // Print the record as text line
+        static void print(Print&, const CatalogEntry&);
+
+
+    // Public Member Functions
+
+        // Append the record of a finished cell
+        bool append(CatalogEntry&);
+
+        // Find the record of the cell ID, return false if none
+        bool find(const uint32_t, CatalogEntry&) const;
+
+        // Print all cells with an average capacity in [CMin, CMax] (mAh),
+        // return the number of cells found
+        unsigned long query(Print&, const float, const float) const;
+
+        // Return the number of records
+        unsigned long size() const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,231 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "endOfCharge.h"
+#include "../format/format.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int EndOfCharge::nMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+EndOfCharge::EndOfCharge
+(
+    const unsigned long window,
+    const int UFull,
+    const int slopeMax,
+    const int sdMax,
+    const int dropMin,
+    const unsigned long timeout
+)
+:
+    window_(10*window),
+    UFull_(UFull),
+    slopeMax_(slopeMax),
+    sdMax_(sdMax),
+    dropMin_(dropMin),
+    timeout_(600*timeout),
+    latency_(0),
+    latencyMax_(0)
+{
+    for (unsigned int i = 0; i < nReasons; ++i)
+    {
+        detections_[i] = 0;
+    }
+
+    reset();
+}
+
+
+EndOfCharge::~EndOfCharge()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+void EndOfCharge::add(const uint32_t t, const int32_t U)
+{
+    // Window is full, remove the oldest sample
+    if (n_ == nMax)
+    {
+        const int64_t tOld = t_[head_];
+        const int64_t UOld = U_[head_];
+
+        St_ -= tOld;
+        Stt_ -= tOld*tOld;
+        SU_ -= UOld;
+        SUU_ -= UOld*UOld;
+        StU_ -= tOld*UOld;
+    }
+    else
+    {
+        ++n_;
+    }
+
+    t_[head_] = t;
+    U_[head_] = uint16_t(U);
+
+    St_ += int64_t(t);
+    Stt_ += int64_t(t)*t;
+    SU_ += U;
+    SUU_ += int64_t(U)*U;
+    StU_ += int64_t(t)*U;
+
+    head_ = (head_ + 1) % nMax;
+}
+
+
+bool EndOfCharge::plateau() const
+{
+    const int64_t n = n_;
+
+    // Mean above UFull and below the maximum of the phase
+    if (SU_ < n*UFull_ || SU_ > n*(UMax_ - dropMin_))
+    {
+        return false;
+    }
+
+    // Variance: (n*SUU - SU^2)/n^2 <= sdMax^2
+    if (n*SUU_ - SU_*SU_ > n*n*sdMax_*sdMax_)
+    {
+        return false;
+    }
+
+    // Slope (mV/0.1 s) = (n*StU - St*SU)/(n*Stt - St^2), 600 per minute
+    const int64_t num = n*StU_ - St_*SU_;
+    const int64_t den = n*Stt_ - St_*St_;
+
+    return den > 0 && 600*(num < 0 ? -num : num) <= slopeMax_*den;
+}
+
+
+// * * * * * * * * * * * * Public Return Functions * * * * * * * * * * * * * //
+
+float EndOfCharge::slope() const
+{
+    const int64_t n = n_;
+    const int64_t den = n*Stt_ - St_*St_;
+
+    return den > 0 ? 600.f*float(n*StU_ - St_*SU_)/float(den) : 0;
+}
+
+
+float EndOfCharge::sd() const
+{
+    if (!n_)
+    {
+        return 0;
+    }
+
+    const int64_t n = n_;
+
+    return sqrt(float(n*SUU_ - SU_*SU_))/n;
+}
+
+
+const char* EndOfCharge::name(const reason r)
+{
+    switch (r)
+    {
+        case TERMINATED:
+            return "charger terminated";
+        case TIMEOUT:
+            return "timeout";
+        default:
+            return "none";
+    }
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+EndOfCharge::reason EndOfCharge::update(const unsigned long t, const float U)
+{
+    const uint32_t tNow = t/100;
+    const int32_t UNow = int32_t(U*1000 + 0.5f);
+
+    if (tFull_ < 0 && UNow >= UFull_)
+    {
+        tFull_ = tNow;
+    }
+
+    // Samples are equally spaced over the window
+    const unsigned int last = (head_ + nMax - 1) % nMax;
+
+    if (!n_ || tNow - t_[last] >= window_/nMax)
+    {
+        add(tNow, UNow);
+
+        // Maximum of the window mean, the noise of single samples would
+        // fake a drop
+        if (n_ == nMax && SU_/int64_t(n_) > UMax_)
+        {
+            UMax_ = int32_t(SU_/int64_t(n_));
+        }
+    }
+
+    reason r = NONE;
+
+    if (n_ == nMax && plateau())
+    {
+        r = TERMINATED;
+    }
+    else if (tNow >= timeout_)
+    {
+        r = TIMEOUT;
+    }
+
+    if (r != NONE)
+    {
+        ++detections_[r];
+
+        latency_ = tFull_ < 0 ? 0 : tNow - tFull_;
+
+        if (latency_ > latencyMax_)
+        {
+            latencyMax_ = latency_;
+        }
+    }
+
+    return r;
+}
+
+
+void EndOfCharge::reset()
+{
+    head_ = 0;
+    n_ = 0;
+    St_ = 0;
+    Stt_ = 0;
+    SU_ = 0;
+    SUU_ = 0;
+    StU_ = 0;
+    UMax_ = 0;
+    tFull_ = -1;
+}
+
+
+void EndOfCharge::report(Print& out) const
+{
+    out << "# End of charge: " << detections_[TERMINATED] << " terminated, "
+        << detections_[TIMEOUT] << " timeout, latency last/max (s): "
+        << latency_/10 << "/" << latencyMax_/10
+        << ", slope (mV/min): " << Format::Fixed(slope(), 2)
+        << ", sd (mV): " << Format::Fixed(sd(), 2) << endl;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,176 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    End-of-charge detector based on the cell voltage only. The voltage is
+    kept in a sliding time window (fixed number of samples, equally spaced
+    over the window). For the window, the running sums of t, t^2, U, U^2
+    and t*U are updated incrementally, hence the least-squares slope dU/dt
+    and the variance of U are available in O(1) per sample. All sums are
+    64 bit integers (mV, 0.1 s), thus they never drift.
+
+    The TP4056-like charger holds the cell at its end-of-charge voltage
+    (CV phase) and switches off if the current dropped below C/10. The cell
+    voltage then falls to its open circuit voltage and stays there. Hence,
+    the charge is finished if
+        - the window is full and its mean is above UFull,
+        - the slope is within +- slopeMax (no trend),
+        - the standard deviation is below sdMax (no noise or steps), and
+        - the mean is at least dropMin below the maximum window mean of
+          the charge phase (the charger terminated, a plateau at the CV
+          voltage does not count).
+    The timeout finishes the charge in any case.
+
+    The latency (time between the first sample above UFull and the
+    detection) and the detections per reason are kept for the report.
+
+SourceFiles
+    endOfCharge.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef endOfCharge_h
+#define endOfCharge_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                         Class EndOfCharge Declaration
+\*---------------------------------------------------------------------------*/
+
+class EndOfCharge
+{
+public:
+
+    // Number of samples in the window
+    static const unsigned int nMax = 32;
+
+    // Result of the detection
+    enum reason { NONE, TERMINATED, TIMEOUT, nReasons };
+
+
+private:
+
+    // Private class data
+
+        // Settings
+
+            // Window length (0.1 s)
+            uint32_t window_;
+
+            // Minimum voltage of a full cell (mV)
+            int32_t UFull_;
+
+            // Maximum slope of the plateau (mV/min)
+            int32_t slopeMax_;
+
+            // Maximum standard deviation of the plateau (mV)
+            int32_t sdMax_;
+
+            // Minimum drop below the maximum voltage of the phase (mV)
+            int32_t dropMin_;
+
+            // Maximum duration of the charge phase (0.1 s)
+            uint32_t timeout_;
+
+
+        // Ring buffer of the window (time in 0.1 s, voltage in mV)
+        uint32_t t_[nMax];
+        uint16_t U_[nMax];
+
+        // Position of the next sample and number of samples
+        unsigned int head_;
+        unsigned int n_;
+
+        // Running sums of the window
+        int64_t St_;
+        int64_t Stt_;
+        int64_t SU_;
+        int64_t SUU_;
+        int64_t StU_;
+
+        // Maximum of the window mean of the charge phase (mV)
+        int32_t UMax_;
+
+        // Time of the first sample above UFull (0.1 s), -1 if none
+        int32_t tFull_;
+
+
+        // Statistics
+
+            // Detections per reason
+            unsigned long detections_[nReasons];
+
+            // Latency of the last and the maximum latency (0.1 s)
+            uint32_t latency_;
+            uint32_t latencyMax_;
+
+
+    // Private Member Functions
+
+        // Add the sample to the window, remove the oldest if full
+        void add(const uint32_t, const int32_t);
+
+        // Return true if the window is a plateau
+        bool plateau() const;
+
+
+public:
+
+    // Constructor (window (s), UFull (mV), slopeMax (mV/min), sdMax (mV),
+    // dropMin (mV), timeout (min))
+    EndOfCharge
+    (
+        const unsigned long,
+        const int,
+        const int,
+        const int,
+        const int,
+        const unsigned long
+    );
+
+    // Destructor
+    ~EndOfCharge();
+
+
+    // Public Return Functions
+
+        // Return the least-squares slope of the window (mV/min)
+        float slope() const;
+
+        // Return the standard deviation of the window (mV)
+        float sd() const;
+
+        // Return the name of the reason
+        static const char* name(const reason);
+
+
+    // Public Member Functions
+
+        // Add the voltage (V) at time t (ms since the start of the charge
+        // phase) and return why the charge is finished (NONE: continue)
+        reason update(const unsigned long, const float);
+
+        // Start a new charge phase
+        void reset();
+
+        // Print the detections and the latency
+        void report(Print&) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
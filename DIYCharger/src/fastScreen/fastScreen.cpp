@@ -0,0 +1,152 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "fastScreen.h"
+#include "../format/format.h"
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+FastScreen::FastScreen
+(
+    const unsigned long tSettle,
+    const unsigned long tPulse,
+    const unsigned long tRecover,
+    const float UMin,
+    const float RMax,
+    const float dURecovery,
+    const float RLoad
+)
+:
+    tSettle_(1000*tSettle),
+    tPulse_(1000*tPulse),
+    tRecover_(1000*tRecover),
+    UMin_(UMin),
+    RMax_(RMax),
+    dURecovery_(dURecovery),
+    RLoad_(RLoad)
+{
+    for (unsigned int i = 0; i < nResults; ++i)
+    {
+        results_[i] = 0;
+    }
+
+    reset();
+}
+
+
+FastScreen::~FastScreen()
+{}
+
+
+// * * * * * * * * * * * * Public Return Functions * * * * * * * * * * * * * //
+
+float FastScreen::R() const
+{
+    // Current during the pulse (A)
+    const float I1 = U1_/RLoad_;
+
+    return I1 > 0 ? (U0_ - U1_)/I1 : 0;
+}
+
+
+const char* FastScreen::name(const result r)
+{
+    switch (r)
+    {
+        case RUNNING:
+            return "running";
+        case PASSED:
+            return "passed";
+        case DEAD:
+            return "voltage collapses under load";
+        case RESISTANCE:
+            return "internal resistance too high";
+        case RECOVERY:
+            return "voltage does not recover";
+        default:
+            return "unknown";
+    }
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+FastScreen::result FastScreen::update(const unsigned long t, const float U)
+{
+    // The voltage of a step is taken at its end (the sampler holds the mean
+    // of the last samples, hence the switching transient is gone)
+    if (step_ == 0 && t >= tSettle_)
+    {
+        U0_ = U;
+        ++step_;
+    }
+    else if (step_ == 1 && t >= tSettle_ + tPulse_)
+    {
+        U1_ = U;
+        ++step_;
+    }
+    else if (step_ == 2 && t >= tSettle_ + tPulse_ + tRecover_)
+    {
+        U2_ = U;
+        ++step_;
+    }
+
+    if (step_ == 3)
+    {
+        result_ = PASSED;
+
+        if (U1_ < UMin_)
+        {
+            result_ = DEAD;
+        }
+        else if (R() > RMax_)
+        {
+            result_ = RESISTANCE;
+        }
+        else if (abs(U2_ - U0_) > dURecovery_)
+        {
+            result_ = RECOVERY;
+        }
+
+        ++results_[result_];
+        ++step_;
+    }
+
+    return result_;
+}
+
+
+void FastScreen::reset()
+{
+    step_ = 0;
+    result_ = RUNNING;
+    U0_ = 0;
+    U1_ = 0;
+    U2_ = 0;
+}
+
+
+void FastScreen::report(Print& out) const
+{
+    out << "# Fast screen: " << results_[PASSED] << " passed, "
+        << results_[DEAD] << " dead, "
+        << results_[RESISTANCE] << " resistance, "
+        << results_[RECOVERY] << " recovery, last U0/U1/U2 (V): "
+        << Format::Fixed(U0_, 3) << "/" << Format::Fixed(U1_, 3) << "/"
+        << Format::Fixed(U2_, 3) << ", R (Ohm): " << Format::Fixed(R(), 3)
+        << endl;
+}
+
+
+// ************************************************************************* //
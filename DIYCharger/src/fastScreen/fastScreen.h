@@ -0,0 +1,143 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Fast screening of a newly inserted cell, before the (hours long) charge
+    and discharge cycles start. The cell is connected to the charger or to
+    the discharge resistance (D1), there is no open circuit state. Hence
+    the screening works with a short discharge pulse:
+
+        1. settle:  charger connected, voltage U0 at the end
+        2. pulse:   discharge resistance connected, voltage U1 at the end
+        3. recover: charger connected again, voltage U2 at the end
+
+    The pulse resistance (U0 - U1)/I1 with I1 = U1/RLoad is the internal
+    resistance of the cell plus the contribution of the charge current
+    (about a factor of two for a 1 A charger). It is compared to RMax. The
+    cell is rejected if
+        - U1 is below UMin (dead cell, the voltage collapses),
+        - the pulse resistance is above RMax (worn out cell), or
+        - U2 does not recover to U0 within the recovery limit.
+
+SourceFiles
+    fastScreen.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef fastScreen_h
+#define fastScreen_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                          Class FastScreen Declaration
+\*---------------------------------------------------------------------------*/
+
+class FastScreen
+{
+public:
+
+    // Result of the screening
+    enum result { RUNNING, PASSED, DEAD, RESISTANCE, RECOVERY, nResults };
+
+
+private:
+
+    // Private class data
+
+        // Settings
+
+            // Duration of the steps settle, pulse and recover (ms)
+            unsigned long tSettle_;
+            unsigned long tPulse_;
+            unsigned long tRecover_;
+
+            // Minimum voltage under load (V)
+            float UMin_;
+
+            // Maximum pulse resistance (Ohm)
+            float RMax_;
+
+            // Maximum difference between U0 and U2 (V)
+            float dURecovery_;
+
+            // Discharge resistance (Ohm)
+            float RLoad_;
+
+
+        // Actual step (settle, pulse, recover, evaluated)
+        uint8_t step_;
+
+        // Result of the last screening
+        result result_;
+
+        // Voltages at the end of the steps (V)
+        float U0_;
+        float U1_;
+        float U2_;
+
+        // Results per type
+        unsigned long results_[nResults];
+
+
+public:
+
+    // Constructor (settle, pulse and recover time (s), minimum voltage
+    // under load (V), maximum pulse resistance (Ohm), maximum recovery
+    // difference (V), discharge resistance (Ohm))
+    FastScreen
+    (
+        const unsigned long,
+        const unsigned long,
+        const unsigned long,
+        const float,
+        const float,
+        const float,
+        const float
+    );
+
+    // Destructor
+    ~FastScreen();
+
+
+    // Public Return Functions
+
+        // Return true if the discharge resistance has to be connected
+        inline bool load() const { return step_ == 1; }
+
+        // Return the pulse resistance (Ohm)
+        float R() const;
+
+        // Return the name of the result
+        static const char* name(const result);
+
+
+    // Public Member Functions
+
+        // Update with the voltage (V) at time t (ms since the start of the
+        // screening) and return the result (RUNNING: continue)
+        result update(const unsigned long, const float);
+
+        // Start a new screening
+        void reset();
+
+        // Print the results and the last measurement
+        void report(Print&) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
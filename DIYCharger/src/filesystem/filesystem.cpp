@@ -13,15 +13,30 @@ License
 
 #include <Streaming.h>
 #include "filesystem.h"
+#include "../hal/hal.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const uint8_t FileSystem::nameSize;
+unsigned int FileSystem::sessions_ = 0;
+unsigned long FileSystem::generation_ = 0;
+unsigned long FileSystem::mounts_ = 0;
+unsigned long FileSystem::opens_ = 0;
+
 
 // * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * ///
 
 FileSystem::FileSystem()
+:
+    fileName_{},
+    fileGeneration_(0)
 {}
 
 
 FileSystem::~FileSystem()
-{}
+{
+    file_.close();
+}
 
 
 // * * * * * * * * * * * * Public Return Functions * * * * * * * * * * * * * //
@@ -32,12 +47,21 @@ FileSystem::~FileSystem()
 
 bool FileSystem::startFS() const
 {
+    // Already mounted by another session
+    if (sessions_ > 0)
+    {
+        ++sessions_;
+        return true;
+    }
+
     if (!LittleFS.begin())
     {
         return false;
     }
     else
     {
+        ++mounts_;
+        ++sessions_;
         return true;
     }
 }
@@ -45,19 +69,54 @@ bool FileSystem::startFS() const
 
 void FileSystem::stopFS() const
 {
-    LittleFS.end();
+    if (sessions_ == 0)
+    {
+        return;
+    }
+
+    if (--sessions_ == 0)
+    {
+        file_.close();
+        LittleFS.end();
+
+        ++generation_;
+    }
+}
+
+
+void FileSystem::report(Print& out)
+{
+    const float hours = hal().millis()/3600e3;
+
+    out << "# LittleFS mounts: " << mounts_;
+
+    if (hours > 0)
+    {
+        out << " (" << mounts_/hours << " per hour)";
+    }
+
+    out << ", opens: " << opens_;
+
+    if (hours > 0)
+    {
+        out << " (" << opens_/hours << " per hour)";
+    }
+
+    out << endl;
 }
 
 
-bool FileSystem::fileExist(const String fileName) const
+bool FileSystem::fileExist(const char* fileName) const
 {
-    return LittleFS.exists(fileName.c_str());
+    return LittleFS.exists(fileName);
 }
 
 
-bool FileSystem::createFile(const String fileName) const
+bool FileSystem::createFile(const char* fileName) const
 {
-    File f = LittleFS.open(fileName.c_str(), "w");
+    closeCachedFile(fileName);
+
+    File f = openFile(fileName, "w");
 
     if (!f)
     {
@@ -73,13 +132,54 @@ bool FileSystem::createFile(const String fileName) const
 
 bool FileSystem::writeData
 (
-    const String fileName,
-    const String data,
-    const String mode,
+    const char* fileName,
+    const char* data,
+    const char* mode,
     const int pos
 ) const
 {
-    File f = LittleFS.open(fileName.c_str(), mode.c_str());
+    return
+        writeData
+        (
+            fileName,
+            reinterpret_cast<const uint8_t*>(data),
+            strlen(data),
+            mode,
+            pos
+        );
+}
+
+
+bool FileSystem::writeData
+(
+    const char* fileName,
+    const uint8_t* data,
+    const size_t n,
+    const char* mode,
+    const int pos
+) const
+{
+    // Appending reuses the cached file handle
+    if (strcmp(mode, "a") == 0 && pos == -1)
+    {
+        File& f = appendFile(fileName);
+
+        if (!f)
+        {
+            return false;
+        }
+
+        const size_t written = f.write(data, n);
+
+        // Commit the data but keep the file open
+        f.flush();
+
+        return written == n;
+    }
+
+    closeCachedFile(fileName);
+
+    File f = openFile(fileName, mode);
 
     if (!f)
     {
@@ -89,28 +189,44 @@ bool FileSystem::writeData
     // If pos is set, move to that position first
     if (pos != -1)
     {
-        Serial<< "move to pos: " << String(pos) << endl;
         f.seek(pos);
     }
 
-    f.print(data);
+    const size_t written = f.write(data, n);
 
     f.close();
 
-    return true;
+    return written == n;
 }
 
 
-bool FileSystem::readFirstLine(const String fileName, String& firstLine) const
+bool FileSystem::readFirstLine
+(
+    const char* fileName,
+    char* firstLine,
+    const size_t n
+) const
 {
-    File f = LittleFS.open(fileName.c_str(), "r");
+    closeCachedFile(fileName);
 
-    if (!f)
+    File f = openFile(fileName, "r");
+
+    if (!f || n == 0)
     {
         return false;
     }
 
-    firstLine = f.readString();
+    // Read into the caller's buffer, no heap allocation
+    const size_t nRead = f.read(reinterpret_cast<uint8_t*>(firstLine), n - 1);
+
+    firstLine[nRead] = '\0';
+
+    char* end = strchr(firstLine, '\n');
+
+    if (end)
+    {
+        *end = '\0';
+    }
 
     f.close();
 
@@ -118,28 +234,121 @@ bool FileSystem::readFirstLine(const String fileName, String& firstLine) const
 }
 
 
-File FileSystem::openFile(const String fileName, const String mode) const
+File FileSystem::openFile(const char* fileName, const char* mode) const
 {
-    File tmp = LittleFS.open(fileName.c_str(), mode.c_str());
+    // Pending appended data have to be visible for the new handle
+    if (file_ && strcmp(fileName_, fileName) == 0)
+    {
+        file_.flush();
+    }
+
+    File tmp = LittleFS.open(fileName, mode);
+
+    if (tmp)
+    {
+        ++opens_;
+    }
 
     return tmp;
 }
 
 
-bool FileSystem::deleteFile(const String fileName) const
+bool FileSystem::deleteFile(const char* fileName) const
+{
+    closeCachedFile(fileName);
+
+    return LittleFS.remove(fileName);
+}
+
+
+void FileSystem::rename(const char* nameOld, const char* nameNew) const
 {
-    return LittleFS.remove(fileName.c_str());
+    // No remount if a session is already open
+    if (startFS())
+    {
+        closeCachedFile(nameOld);
+        closeCachedFile(nameNew);
+        LittleFS.rename(nameOld, nameNew);
+        stopFS();
+    }
 }
 
 
-void FileSystem::rename(const String nameOld, const String nameNew) const
+File FileSystem::beginReplace(const char* fileName) const
 {
-    startFS();
-    LittleFS.rename(nameOld, nameNew);
-    stopFS();
+    char tmp[nameSize];
+    tmpName(fileName, tmp);
+
+    deleteFile(tmp);
+
+    return openFile(tmp, "w");
+}
+
+
+bool FileSystem::endReplace
+(
+    const char* fileName,
+    File& f,
+    const bool complete
+) const
+{
+    char tmp[nameSize];
+    tmpName(fileName, tmp);
+
+    const bool success = bool(f) && complete;
+
+    f.close();
+
+    // The rename is atomic, a reset leaves either the old or the new file
+    if (success)
+    {
+        rename(tmp, fileName);
+    }
+    else
+    {
+        deleteFile(tmp);
+    }
+
+    return success;
 }
 
 
 // * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
 
+void FileSystem::tmpName(const char* fileName, char* tmp)
+{
+    snprintf(tmp, nameSize, "%s.tmp", fileName);
+}
+
+
+File& FileSystem::appendFile(const char* fileName) const
+{
+    if
+    (
+        !file_
+     || strcmp(fileName_, fileName) != 0
+     || fileGeneration_ != generation_
+    )
+    {
+        file_.close();
+
+        file_ = openFile(fileName, "a");
+        strncpy(fileName_, fileName, nameSize - 1);
+        fileName_[nameSize - 1] = '\0';
+        fileGeneration_ = generation_;
+    }
+
+    return file_;
+}
+
+
+void FileSystem::closeCachedFile(const char* fileName) const
+{
+    if (strcmp(fileName_, fileName) == 0)
+    {
+        file_.close();
+        fileName_[0] = '\0';
+    }
+}
+
 // ************************************************************************* //
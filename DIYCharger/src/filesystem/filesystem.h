@@ -14,6 +14,15 @@ Description
     It handles the correct data manipulation and all IOs which are needed
     for the battery discharge and charging process
 
+    The file system is a reference counted session shared by all objects:
+    it is only mounted by the first startFS() and unmounted by the last
+    stopFS(). If the sketch keeps one session open (setup), LittleFS is
+    mounted exactly once. Furthermore, the file handle used for appending
+    is kept open and reused by the following calls.
+
+    File names are null-terminated strings of at most nameSize - 1
+    characters; no name is kept on the heap.
+
 SourceFiles
     filesystem.cpp
 
@@ -33,11 +42,51 @@ SourceFiles
 
 class FileSystem
 {
+public:
+
+    // Maximum size of a file name including the temporary suffix and the
+    // terminating null (LittleFS)
+    static const uint8_t nameSize = 32;
+
+
+private:
+
+    // Private static data
+
+        // Number of open sessions
+        static unsigned int sessions_;
+
+        // Increased on each unmount (invalidates all cached file handles)
+        static unsigned long generation_;
+
+        // Statistics: number of mounts and opened files
+        static unsigned long mounts_;
+        static unsigned long opens_;
+
+
     // Private class data
 
+        // Cached file handle for appending data
+        mutable File file_;
+
+        // File name of the cached file handle
+        mutable char fileName_[nameSize];
+
+        // Session generation of the cached file handle
+        mutable unsigned long fileGeneration_;
+
+
+    // Private Member Functions
 
-        // File name that holds the measurement data
-        String fileName_;
+        // Write the name of the temporary file of the file into the buffer
+        // of nameSize bytes
+        static void tmpName(const char*, char*);
+
+        // Return the cached file handle for appending to the file
+        File& appendFile(const char*) const;
+
+        // Close the cached file handle if it belongs to the file
+        void closeCachedFile(const char*) const;
 
 public:
 
@@ -53,52 +102,67 @@ public:
 
     // Public Return Functions
 
+        // Return the number of mounts since start-up
+        static inline unsigned long mounts() { return mounts_; }
+
+        // Return the number of opened files since start-up
+        static inline unsigned long opens() { return opens_; }
+
 
     // Public Member Functions
 
-        // Start the LittleFS system
+        // Start the LittleFS system (mount only if no session is open)
         bool startFS() const;
 
-        // Stop the LittleFS system
+        // Stop the LittleFS system (unmount if it was the last session)
         void stopFS() const;
 
+        // Print the number of mounts and opens (total and per hour)
+        static void report(Print&);
+
         // Check if file exist
-        bool fileExist(const String) const;
+        bool fileExist(const char*) const;
 
         // Creat an empty file
-        bool createFile(const String) const;
+        bool createFile(const char*) const;
 
-        // Write data into a file
+        // Write the text into a file
         bool writeData
         (
-            const String,
-            const String,
-            const String mode = "w",
+            const char*,
+            const char*,
+            const char* mode = "w",
             const int pos = -1
         ) const;
 
-        // Read first line of file
-        bool readFirstLine(const String, String&) const;
+        // Write raw bytes into a file
+        bool writeData
+        (
+            const char*,
+            const uint8_t*,
+            const size_t,
+            const char* mode = "a",
+            const int pos = -1
+        ) const;
+
+        // Read the first line of the file into the buffer of the given size
+        bool readFirstLine(const char*, char*, const size_t) const;
 
         // Open the file for reading (default) or writing
-        File openFile(const String, const String = "r") const;
+        File openFile(const char*, const char* = "r") const;
 
         // Remove the specified file from the flash
-        bool deleteFile(const String) const;
+        bool deleteFile(const char*) const;
 
         // Rename the file
-        void rename(const String, const String) const;
-
-
-private:
-
-    // Private Member Functions
-
-        // Read the actualCellID file and return the integer
-
+        void rename(const char*, const char*) const;
 
-        // Write the given content into the file
+        // Open the temporary file of an atomic replacement of the file
+        File beginReplace(const char*) const;
 
+        // Close the temporary file and replace the file by it if its
+        // content is complete (removed otherwise), return the success
+        bool endReplace(const char*, File&, const bool) const;
 };
 
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
@@ -0,0 +1,200 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "format.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const uint8_t Format::maxDecimals;
+
+
+// * * * * * * * * * * * * * * * Local Functions * * * * * * * * * * * * * * //
+
+namespace
+{
+    const uint32_t pow10[] =
+        {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+
+    // Write the digits of n (reversed) and return their number
+    size_t digits(char* buf, uint32_t n, const size_t minDigits)
+    {
+        size_t i = 0;
+
+        do
+        {
+            buf[i++] = char('0' + n % 10);
+            n /= 10;
+        }
+        while (n || i < minDigits);
+
+        return i;
+    }
+
+
+    // Copy the reversed digits
+    size_t reverse(char* out, const char* rev, const size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            out[i] = rev[n - 1 - i];
+        }
+
+        return n;
+    }
+}
+
+
+// * * * * * * * * * * * * * * Public Static Functions * * * * * * * * * * * //
+
+size_t Format::fixed(char* buf, const float x, const uint8_t decimals)
+{
+    const uint8_t d = decimals > maxDecimals ? maxDecimals : decimals;
+
+    size_t n = 0;
+
+    if (isnan(x))
+    {
+        memcpy(buf, "nan", 3);
+        return 3;
+    }
+
+    float a = x;
+
+    if (a < 0)
+    {
+        buf[n++] = '-';
+        a = -a;
+    }
+
+    // Scale and round once, all further steps are integer operations
+    const float scaled = a*pow10[d] + 0.5f;
+
+    if (isinf(x) || scaled >= 4294967040.f)
+    {
+        memcpy(buf + n, "ovf", 3);
+        return n + 3;
+    }
+
+    const uint32_t value = uint32_t(scaled);
+
+    char rev[12];
+
+    n += reverse(buf + n, rev, digits(rev, value/pow10[d], 1));
+
+    if (d)
+    {
+        buf[n++] = '.';
+        n += reverse(buf + n, rev, digits(rev, value % pow10[d], d));
+    }
+
+    return n;
+}
+
+
+size_t Format::integer(char* buf, const long x)
+{
+    size_t n = 0;
+    unsigned long a = x;
+
+    if (x < 0)
+    {
+        buf[n++] = '-';
+        a = 0UL - a;
+    }
+
+    char rev[12];
+
+    return n + reverse(buf + n, rev, digits(rev, uint32_t(a), 1));
+}
+
+
+size_t Format::decimal
+(
+    Print& out,
+    const int64_t raw,
+    const int8_t exponent,
+    const uint8_t decimals
+)
+{
+    const uint8_t d = decimals > maxDecimals ? maxDecimals : decimals;
+
+    // Value in units of 10^-d, rounded half away from zero
+    int64_t value = raw;
+    int shift = exponent + d;
+
+    for (; shift > 0; --shift)
+    {
+        value *= 10;
+    }
+
+    for (; shift < -1; ++shift)
+    {
+        value /= 10;
+    }
+
+    if (shift == -1)
+    {
+        value = (value + (value < 0 ? -5 : 5))/10;
+    }
+
+    char buf[24];
+    size_t n = 0;
+
+    uint64_t a = value;
+
+    if (value < 0)
+    {
+        buf[n++] = '-';
+        a = 0ULL - a;
+    }
+
+    char rev[12];
+
+    const uint64_t intPart = a/pow10[d];
+
+    if (intPart > 0xFFFFFFFFULL)
+    {
+        memcpy(buf + n, "ovf", 3);
+        return out.write(reinterpret_cast<const uint8_t*>(buf), n + 3);
+    }
+
+    n += reverse(buf + n, rev, digits(rev, uint32_t(intPart), 1));
+
+    if (d)
+    {
+        buf[n++] = '.';
+        n += reverse(buf + n, rev, digits(rev, uint32_t(a % pow10[d]), d));
+    }
+
+    return out.write(reinterpret_cast<const uint8_t*>(buf), n);
+}
+
+
+size_t Format::fixed(Print& out, const float x, const uint8_t decimals)
+{
+    char buf[24];
+
+    return out.write(reinterpret_cast<const uint8_t*>(buf), fixed(buf, x, decimals));
+}
+
+
+size_t Format::integer(Print& out, const long x)
+{
+    char buf[12];
+
+    return out.write(reinterpret_cast<const uint8_t*>(buf), integer(buf, x));
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,214 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Heap-free formatting. Format converts numbers into text using integer
+    arithmetic only (the float is scaled and rounded once, no digit-wise
+    float multiplications) and writes the digits directly into any Print
+    object (Serial, File or a Formatter).
+
+    Formatter is a fixed-capacity text buffer on the stack. It is a Print
+    object itself, hence it works with the Streaming operator << as well.
+    Text that does not fit is cut and flagged as overflow.
+
+SourceFiles
+    format.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef format_h
+#define format_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Format Declaration
+\*---------------------------------------------------------------------------*/
+
+class Format
+{
+public:
+
+    // Maximum number of decimals
+    static const uint8_t maxDecimals = 6;
+
+    // Float with a given number of decimals for the stream operator, e.g.,
+    // Serial << "U = " << Format::Fixed(U, 4) << endl;
+    struct Fixed
+    {
+        float value;
+        uint8_t decimals;
+
+        Fixed(const float x, const uint8_t d) : value(x), decimals(d) {}
+    };
+
+
+    // Public Static Functions
+
+        // Write the float with the given number of decimals into the buffer
+        // (at least 24 characters, not null terminated) and return the
+        // number of characters
+        static size_t fixed(char*, const float, const uint8_t);
+
+        // Write the integer into the buffer (at least 12 characters, not
+        // null terminated) and return the number of characters
+        static size_t integer(char*, const long);
+
+        // Write the float with the given number of decimals
+        static size_t fixed(Print&, const float, const uint8_t);
+
+        // Write the integer
+        static size_t integer(Print&, const long);
+
+        // Write raw*10^exponent with the given number of decimals, e.g., a
+        // fixed-point value of the measurement file (integer only)
+        static size_t decimal
+        (
+            Print&,
+            const int64_t raw,
+            const int8_t exponent,
+            const uint8_t decimals
+        );
+};
+
+
+// * * * * * * * * * * * * * * * Global Operators  * * * * * * * * * * * * //
+
+inline Print& operator<<(Print& out, const Format::Fixed& x)
+{
+    Format::fixed(out, x.value, x.decimals);
+    return out;
+}
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Formatter Declaration
+\*---------------------------------------------------------------------------*/
+
+template<size_t N>
+class Formatter
+:
+    public Print
+{
+    // Private class data
+
+        // Text buffer (null terminated)
+        char buffer_[N];
+
+        // Number of characters
+        size_t n_;
+
+        // Text was cut
+        bool overflow_;
+
+
+public:
+
+    // Constructor
+    Formatter()
+    :
+        n_(0),
+        overflow_(false)
+    {
+        buffer_[0] = '\0';
+    }
+
+
+    // Public Return Functions
+
+        // Return the text
+        inline const char* c_str() const { return buffer_; }
+
+        // Return the text as raw bytes
+        inline const uint8_t* data() const
+        {
+            return reinterpret_cast<const uint8_t*>(buffer_);
+        }
+
+        // Return the number of characters
+        inline size_t length() const { return n_; }
+
+        // Return true if text was cut
+        inline bool overflow() const { return overflow_; }
+
+
+    // Public Member Functions
+
+        using Print::write;
+
+        size_t write(const uint8_t c)
+        {
+            if (n_ + 1 >= N)
+            {
+                overflow_ = true;
+                return 0;
+            }
+
+            buffer_[n_++] = char(c);
+            buffer_[n_] = '\0';
+
+            return 1;
+        }
+
+        size_t write(const uint8_t* data, size_t n)
+        {
+            size_t written = 0;
+
+            while (n-- && write(*data++))
+            {
+                ++written;
+            }
+
+            return written;
+        }
+
+        // Append the float with the given number of decimals
+        Formatter& fixed(const float x, const uint8_t decimals)
+        {
+            Format::fixed(*this, x, decimals);
+            return *this;
+        }
+
+        // Append the integer
+        Formatter& integer(const long x)
+        {
+            Format::integer(*this, x);
+            return *this;
+        }
+
+        // Append the character n times
+        Formatter& fill(const char c, unsigned int n)
+        {
+            while (n--)
+            {
+                write(uint8_t(c));
+            }
+
+            return *this;
+        }
+
+        // Remove all characters
+        void clear()
+        {
+            n_ = 0;
+            overflow_ = false;
+            buffer_[0] = '\0';
+        }
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
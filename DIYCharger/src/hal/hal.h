@@ -0,0 +1,97 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Hardware abstraction layer (HAL) of the BatteryCharger project. All
+    classes access the clock, the ADC and the digital pins through this
+    interface and never call the Arduino core directly. Hence, the complete
+    charger logic can run on the Wemos D1 (ESP8266 backend) as well as on a
+    Linux desktop (host backend, see host/) with a virtual clock and a
+    scripted ADC.
+
+    The backend is selected at link time by the implementation of hal().
+
+SourceFiles
+    halESP8266.cpp (board)
+    host/src/halHost.cpp (desktop)
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef hal_h
+#define hal_h
+
+#include <stdint.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class HAL Declaration
+\*---------------------------------------------------------------------------*/
+
+class HAL
+{
+public:
+
+    // Destructor
+    virtual ~HAL() {}
+
+
+    // Public Clock Functions
+
+        // Return the milliseconds since start-up
+        virtual unsigned long millis() const = 0;
+
+        // Return the microseconds since start-up
+        virtual unsigned long micros() const = 0;
+
+        // Wait for the given milliseconds
+        virtual void delay(const unsigned long) = 0;
+
+        // Busy wait for the given microseconds (short waits only)
+        virtual void delayMicroseconds(const unsigned int) = 0;
+
+
+    // Public IO Functions
+
+        // Set the pin mode (INPUT, OUTPUT)
+        virtual void pinMode(const uint8_t, const uint8_t) = 0;
+
+        // Set the digital output (LOW, HIGH)
+        virtual void digitalWrite(const uint8_t, const uint8_t) = 0;
+
+        // Read the digital input (LOW, HIGH)
+        virtual int digitalRead(const uint8_t) const = 0;
+
+        // Read the raw ADC counts (0 ... 1023)
+        virtual int analogRead(const uint8_t) = 0;
+
+
+    // Public System Functions
+
+        // Return the free heap (bytes)
+        virtual uint32_t freeHeap() const = 0;
+
+        // Return the largest allocatable heap block (bytes)
+        virtual uint32_t maxFreeBlock() const = 0;
+};
+
+
+// * * * * * * * * * * * * * * * Global Functions  * * * * * * * * * * * * * //
+
+// Return the hardware backend (implemented once per backend)
+HAL& hal();
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,106 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include "halESP8266.h"
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+HALESP8266::HALESP8266()
+{}
+
+
+HALESP8266::~HALESP8266()
+{}
+
+
+// * * * * * * * * * * * * Public Clock Functions  * * * * * * * * * * * * * //
+
+unsigned long HALESP8266::millis() const
+{
+    return ::millis();
+}
+
+
+unsigned long HALESP8266::micros() const
+{
+    return ::micros();
+}
+
+
+void HALESP8266::delay(const unsigned long ms)
+{
+    ::delay(ms);
+}
+
+
+void HALESP8266::delayMicroseconds(const unsigned int us)
+{
+    ::delayMicroseconds(us);
+}
+
+
+// * * * * * * * * * * * * * Public IO Functions * * * * * * * * * * * * * * //
+
+void HALESP8266::pinMode(const uint8_t pin, const uint8_t mode)
+{
+    ::pinMode(pin, mode);
+}
+
+
+void HALESP8266::digitalWrite(const uint8_t pin, const uint8_t value)
+{
+    ::digitalWrite(pin, value);
+}
+
+
+int HALESP8266::digitalRead(const uint8_t pin) const
+{
+    return ::digitalRead(pin);
+}
+
+
+int HALESP8266::analogRead(const uint8_t pin)
+{
+    return ::analogRead(pin);
+}
+
+
+// * * * * * * * * * * * * Public System Functions * * * * * * * * * * * * //
+
+uint32_t HALESP8266::freeHeap() const
+{
+    return ESP.getFreeHeap();
+}
+
+
+uint32_t HALESP8266::maxFreeBlock() const
+{
+    return ESP.getMaxFreeBlockSize();
+}
+
+
+// * * * * * * * * * * * * * * * Global Functions  * * * * * * * * * * * * * //
+
+HAL& hal()
+{
+    static HALESP8266 board;
+
+    return board;
+}
+
+#endif
+
+// ************************************************************************* //
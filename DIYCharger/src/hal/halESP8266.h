@@ -0,0 +1,84 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    ESP8266 (Wemos D1 mini) backend of the hardware abstraction layer. The
+    functions simply forward to the Arduino core. This backend is only
+    compiled if the sketch is built by the Arduino toolchain.
+
+SourceFiles
+    halESP8266.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef halESP8266_h
+#define halESP8266_h
+
+#ifdef ARDUINO
+
+#include "hal.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class HALESP8266 Declaration
+\*---------------------------------------------------------------------------*/
+
+class HALESP8266
+:
+    public HAL
+{
+public:
+
+    // Constructor
+    HALESP8266();
+
+    // Destructor
+    ~HALESP8266();
+
+
+    // Public Clock Functions
+
+        unsigned long millis() const;
+
+        unsigned long micros() const;
+
+        void delay(const unsigned long);
+
+        void delayMicroseconds(const unsigned int);
+
+
+    // Public IO Functions
+
+        void pinMode(const uint8_t, const uint8_t);
+
+        void digitalWrite(const uint8_t, const uint8_t);
+
+        int digitalRead(const uint8_t) const;
+
+        int analogRead(const uint8_t);
+
+
+    // Public System Functions
+
+        uint32_t freeHeap() const;
+
+        uint32_t maxFreeBlock() const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+#endif
+
+// ************************************************************************* //
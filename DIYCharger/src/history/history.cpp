@@ -0,0 +1,209 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "history.h"
+#include "../format/format.h"
+#include "../hal/hal.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int History::nMax;
+
+
+// * * * * * * * * * * * * * * * Local Constants * * * * * * * * * * * * * * //
+
+namespace
+{
+    // Samples per line of a dump and maximum length of a line
+    const unsigned int samplesPerLine = 10;
+    const size_t lineSize = 5*samplesPerLine + 1;
+}
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+History::History
+(
+    uint8_t* data,
+    const size_t size,
+    const unsigned int nChannels,
+    const unsigned long period
+)
+:
+    data_(data),
+    n_(nChannels < nMax ? nChannels : nMax),
+    capacity_(n_ ? 4*(size/(5*n_)) : 0),
+    period_(period),
+    dumpChannel_(-1),
+    dumpNext_(0),
+    dumpEnd_(0),
+    dumpT_(0),
+    dumpLost_(0),
+    dumpHeader_(false)
+{
+    for (unsigned int i = 0; i < nMax; ++i)
+    {
+        written_[i] = 0;
+        tLatest_[i] = 0;
+    }
+}
+
+
+History::~History()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+uint16_t History::get(const unsigned int channel, const uint32_t i) const
+{
+    const uint32_t j = i % capacity_;
+    const uint8_t* group = data_ + 5*(channel*(capacity_/4) + j/4);
+
+    // Sample k of a group starts at bit 10*k
+    const unsigned int bit = 10*(j % 4);
+    const uint16_t word = group[bit/8] | (uint16_t(group[bit/8 + 1]) << 8);
+
+    return (word >> (bit % 8)) & 0x3FF;
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void History::add(const unsigned int channel, const int raw)
+{
+    if (channel >= n_ || !capacity_)
+    {
+        return;
+    }
+
+    const uint32_t j = written_[channel] % capacity_;
+    uint8_t* group = data_ + 5*(channel*(capacity_/4) + j/4);
+
+    const unsigned int bit = 10*(j % 4);
+    const uint16_t mask = 0x3FF << (bit % 8);
+    const uint16_t value = (uint16_t(constrain(raw, 0, 1023)) << (bit % 8));
+
+    uint16_t word = group[bit/8] | (uint16_t(group[bit/8 + 1]) << 8);
+    word = (word & ~mask) | value;
+
+    group[bit/8] = uint8_t(word);
+    group[bit/8 + 1] = uint8_t(word >> 8);
+
+    // Count after the sample is stored, a dump never reads a half written
+    // sample
+    ++written_[channel];
+    tLatest_[channel] = hal().millis();
+}
+
+
+bool History::dump(const unsigned int channel)
+{
+    if (channel >= n_ || !capacity_ || dumping())
+    {
+        return false;
+    }
+
+    dumpChannel_ = int(channel);
+    dumpEnd_ = written_[channel];
+    dumpNext_ = dumpEnd_ - size(channel);
+    dumpT_ = tLatest_[channel];
+    dumpLost_ = 0;
+    dumpHeader_ = false;
+
+    return true;
+}
+
+
+void History::dumpNext(Print& out, size_t budget)
+{
+    if (!dumping())
+    {
+        return;
+    }
+
+    const unsigned int channel = unsigned(dumpChannel_);
+
+    if (budget < lineSize)
+    {
+        return;
+    }
+
+    // Header at the start of the dump
+    if (!dumpHeader_)
+    {
+        out << "# Raw samples of slot " << channel << ": "
+            << dumpEnd_ - dumpNext_ << " samples every " << period_
+            << " ms up to t = " << dumpT_ << " ms" << endl;
+
+        dumpHeader_ = true;
+
+        return;
+    }
+
+    while (budget >= lineSize && dumpNext_ != dumpEnd_)
+    {
+        // Skip the samples which were overwritten meanwhile, never beyond
+        // the end sample (the dump fell behind by more than the ring)
+        const uint32_t oldest = written_[channel] - size(channel);
+
+        if (int32_t(oldest - dumpNext_) > 0)
+        {
+            const uint32_t next =
+                int32_t(oldest - dumpEnd_) > 0 ? dumpEnd_ : oldest;
+
+            dumpLost_ += next - dumpNext_;
+            dumpNext_ = next;
+
+            if (dumpNext_ == dumpEnd_)
+            {
+                break;
+            }
+        }
+
+        char line[lineSize + 12];
+        size_t n = 0;
+
+        for
+        (
+            unsigned int k = 0;
+            k < samplesPerLine && dumpNext_ != dumpEnd_;
+            ++k, ++dumpNext_
+        )
+        {
+            if (k)
+            {
+                line[n++] = ' ';
+            }
+
+            n += Format::integer(line + n, get(channel, dumpNext_));
+        }
+
+        line[n++] = '\n';
+
+        out.write(reinterpret_cast<const uint8_t*>(line), n);
+        budget -= n;
+    }
+
+    if (dumpNext_ == dumpEnd_)
+    {
+        out << "# End of raw samples of slot " << channel << " ("
+            << dumpLost_ << " overwritten)" << endl;
+
+        dumpChannel_ = -1;
+    }
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,144 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    High-resolution history of the raw ADC samples of all slots. The
+    acquisition engine adds each sample (full acquisition rate) to the ring
+    of its channel, hence the last minutes before an event (end of charge,
+    thermal event, failure) can be inspected afterwards. The measurement
+    file is fed from the same samples by the decimating stages (sampler and
+    swinging door), it never reads the history.
+
+    The memory is a fixed buffer given by the sketch, shared equally by the
+    channels. The 10 bit samples are packed, four samples into five bytes.
+
+    A dump is streamed by the dump task in small pieces (only as much as
+    the UART takes without waiting), hence it never blocks the sampling.
+    The ring is not locked during a dump: each channel counts its samples
+    since start-up, the dump reads from the oldest sample up to the sample
+    of the trigger and skips the samples which were overwritten meanwhile.
+
+SourceFiles
+    history.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef history_h
+#define history_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class History Declaration
+\*---------------------------------------------------------------------------*/
+
+class History
+{
+public:
+
+    // Maximum number of channels (16 channel multiplexer)
+    static const unsigned int nMax = 16;
+
+
+private:
+
+    // Private class data
+
+        // Packed samples of all channels
+        uint8_t* data_;
+
+        // Number of channels
+        unsigned int n_;
+
+        // Number of samples per channel (multiple of four)
+        uint32_t capacity_;
+
+        // Sample period of each channel (ms)
+        unsigned long period_;
+
+        // Number of samples since start-up and time of the latest sample
+        // (ms) of each channel
+        uint32_t written_[nMax];
+        unsigned long tLatest_[nMax];
+
+
+        // Running dump
+
+            // Channel (-1 if none), next and end sample
+            int dumpChannel_;
+            uint32_t dumpNext_;
+            uint32_t dumpEnd_;
+
+            // Time of the end sample (ms)
+            unsigned long dumpT_;
+
+            // Samples overwritten before they were dumped
+            uint32_t dumpLost_;
+
+            // Header is written
+            bool dumpHeader_;
+
+
+    // Private Member Functions
+
+        // Return the sample of the channel at the absolute position
+        uint16_t get(const unsigned int, const uint32_t) const;
+
+
+public:
+
+    // Constructor (buffer, size of the buffer (bytes), number of channels,
+    // sample period of each channel (ms))
+    History(uint8_t*, const size_t, const unsigned int, const unsigned long);
+
+    // Destructor
+    ~History();
+
+
+    // Public Return Functions
+
+        // Return the number of samples per channel
+        inline uint32_t capacity() const { return capacity_; }
+
+        // Return the number of stored samples of the channel
+        inline uint32_t size(const unsigned int channel) const
+        {
+            return written_[channel] < capacity_
+                 ? written_[channel]
+                 : capacity_;
+        }
+
+        // Return true if a dump is running
+        inline bool dumping() const { return dumpChannel_ >= 0; }
+
+
+    // Public Member Functions
+
+        // Add the raw sample of the channel
+        void add(const unsigned int, const int);
+
+        // Start the dump of all stored samples of the channel (a running
+        // dump is finished first), return false if not possible
+        bool dump(const unsigned int);
+
+        // Write the next lines of the running dump, at most the given
+        // number of bytes
+        void dumpNext(Print&, size_t);
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,69 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "integrator.h"
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Integrator::Integrator()
+:
+    sum_(0),
+    yOld_(0),
+    first_(true)
+{}
+
+
+Integrator::~Integrator()
+{}
+
+
+// * * * * * * * * * * * * Public Return Functions * * * * * * * * * * * * * //
+
+float Integrator::hours(const float factor) const
+{
+    // The sum is twice the integral in ms: 2*3600*1000 ms per hour
+    return float(double(sum_)/(7.2e6*factor));
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void Integrator::add(const uint32_t dt, const int64_t y)
+{
+    if (first_)
+    {
+        yOld_ = y;
+        first_ = false;
+    }
+
+    sum_ += (yOld_ + y)*int64_t(dt);
+    yOld_ = y;
+}
+
+
+void Integrator::reset()
+{
+    sum_ = 0;
+    yOld_ = 0;
+    first_ = true;
+}
+
+
+void Integrator::restore(const int64_t sum)
+{
+    reset();
+    sum_ = sum;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,87 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Integer time integration of a signal (e.g., current or power) with the
+    trapezoidal rule over exact millisecond steps. The ESP8266 has no FPU,
+    hence the integral is accumulated in 64 bit integers without any
+    rounding error: the sum holds (y_old + y_new)*dt, i.e., twice the
+    integral in the unit of the signal times ms. A float is only produced
+    when the value is reported.
+
+SourceFiles
+    integrator.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef integrator_h
+#define integrator_h
+
+#include <stdint.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Integrator Declaration
+\*---------------------------------------------------------------------------*/
+
+class Integrator
+{
+    // Private class data
+
+        // Twice the integral (signal unit * ms)
+        int64_t sum_;
+
+        // Signal of the last step
+        int64_t yOld_;
+
+        // No step since the last reset
+        bool first_;
+
+
+public:
+
+    // Constructor
+    Integrator();
+
+    // Destructor
+    ~Integrator();
+
+
+    // Public Return Functions
+
+        // Return the integral in units of the signal times hours divided
+        // by the given factor, e.g., uA -> mAh with 1000
+        float hours(const float = 1) const;
+
+        // Return the raw sum (for checkpoints)
+        inline int64_t sum() const { return sum_; }
+
+
+    // Public Member Functions
+
+        // Add the step of dt (ms) ending with the signal y
+        // The first step after a reset uses y over the whole step
+        void add(const uint32_t, const int64_t);
+
+        // Remove the integral
+        void reset();
+
+        // Continue with the raw sum of a checkpoint
+        void restore(const int64_t);
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,212 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "journal.h"
+#include "../log/log.h"
+#include "../record/record.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const uint8_t Journal::magic;
+const uint8_t Journal::version;
+const unsigned int Journal::nSlotsMax;
+const unsigned int Journal::nRecordsMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Journal::Journal()
+:
+    name_("journal"),
+    scanned_(false),
+    n_(0)
+{
+    for (unsigned int i = 0; i < nSlotsMax; ++i)
+    {
+        found_[i] = false;
+    }
+}
+
+
+Journal::~Journal()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+bool Journal::valid(const Checkpoint& c)
+{
+    return
+        c.magic == magic
+     && c.version == version
+     && c.slot < nSlotsMax
+     && Record::valid(c);
+}
+
+
+long Journal::scan()
+{
+    for (unsigned int i = 0; i < nSlotsMax; ++i)
+    {
+        found_[i] = false;
+    }
+
+    if (!fileExist(name_))
+    {
+        return 0;
+    }
+
+    File f = openFile(name_);
+
+    if (!f)
+    {
+        return 0;
+    }
+
+    const size_t size = f.size();
+
+    Checkpoint c;
+    long n = 0;
+
+    while (f.read(reinterpret_cast<uint8_t*>(&c), sizeof(c)) == sizeof(c))
+    {
+        if (valid(c))
+        {
+            latest_[c.slot] = c;
+            found_[c.slot] = true;
+        }
+
+        ++n;
+    }
+
+    f.close();
+
+    return size % sizeof(Checkpoint) ? -1 : n;
+}
+
+
+void Journal::load()
+{
+    if (!scanned_)
+    {
+        n_ = scan();
+        scanned_ = true;
+    }
+}
+
+
+bool Journal::compact()
+{
+    // Write the latest records into the temporary file
+    File f = beginReplace(name_);
+
+    if (!f)
+    {
+        LOGE("ERROR: File '" << name_ << "' could not be compacted" << endl);
+        return false;
+    }
+
+    n_ = 0;
+
+    for (unsigned int i = 0; i < nSlotsMax; ++i)
+    {
+        if (found_[i])
+        {
+            f.write(reinterpret_cast<const uint8_t*>(&latest_[i]), sizeof(Checkpoint));
+            ++n_;
+        }
+    }
+
+    // Atomic replacement of the journal
+    return endReplace(name_, f, true);
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+bool Journal::write(Checkpoint& c)
+{
+    if (c.slot >= nSlotsMax)
+    {
+        return false;
+    }
+
+    c.magic = magic;
+    c.version = version;
+    Record::seal(c);
+
+    bool success = false;
+
+    if (startFS())
+    {
+        // First access after start-up, check for a torn record
+        load();
+
+        if (n_ < 0 || n_ >= long(nRecordsMax))
+        {
+            compact();
+        }
+
+        success =
+            FileSystem::writeData
+            (
+                name_,
+                reinterpret_cast<const uint8_t*>(&c),
+                sizeof(c),
+                "a"
+            );
+
+        if (success)
+        {
+            ++n_;
+            latest_[c.slot] = c;
+            found_[c.slot] = true;
+        }
+        else
+        {
+            LOGE("ERROR: File '" << name_ << "' not written" << endl);
+        }
+
+        stopFS();
+    }
+
+    return success;
+}
+
+
+bool Journal::read(const uint8_t slot, Checkpoint& c)
+{
+    if (slot >= nSlotsMax)
+    {
+        return false;
+    }
+
+    if (!scanned_ && startFS())
+    {
+        load();
+        stopFS();
+    }
+
+    if (!found_[slot])
+    {
+        return false;
+    }
+
+    c = latest_[slot];
+
+    return true;
+}
+
+
+// ************************************************************************* //
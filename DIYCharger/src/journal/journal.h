@@ -0,0 +1,161 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Crash-safe journal of the test state of all slots. A checkpoint is a
+    fixed-size binary record (protected by a CRC) which is appended to the
+    journal file, hence each checkpoint programs only a few bytes of a
+    flash page and never rewrites old data. The latest valid record of a
+    slot wins. A torn record of a reset during the write fails the CRC and
+    is ignored, as well as a record of another format version.
+
+    If the journal reached its maximum size (or its size is no multiple of
+    the record size after a torn write), it is compacted: the latest record
+    of each slot is written into a temporary file which replaces the
+    journal by an atomic rename.
+
+    The journal is scanned once after start-up; afterwards the latest
+    record of each slot is served from the cache of the Journal, which is
+    the only scratch memory of the records (no arrays on the stack).
+
+SourceFiles
+    journal.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef journal_h
+#define journal_h
+
+#include "../filesystem/filesystem.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Struct Checkpoint Declaration
+\*---------------------------------------------------------------------------*/
+
+struct __attribute__((packed)) Checkpoint
+{
+    // Magic byte and format version (see Journal)
+    uint8_t magic;
+    uint8_t version;
+
+    // Slot, mode and number of finished discharges
+    uint8_t slot;
+    uint8_t mode;
+    uint16_t nDischarges;
+
+    // Time since the start of the phase (ms)
+    uint32_t t;
+
+    // Cell voltage (mV)
+    uint16_t U;
+
+    // Integrals of the current and the power (see Integrator) and their
+    // values at the start of the discharge (see Battery::pause)
+    int64_t C;
+    int64_t e;
+    int64_t CStart;
+    int64_t eStart;
+
+    // The discharge is repeated after a pause
+    uint8_t repeat;
+
+    // Sum of the capacities and energies of the finished cycles
+    float CAve;
+    float eAve;
+
+    // CRC-16 of all fields above
+    uint16_t crc;
+};
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Journal Declaration
+\*---------------------------------------------------------------------------*/
+
+class Journal
+:
+    public FileSystem
+{
+public:
+
+    // Magic byte and format version of the records. The version follows
+    // the one of the measurement files (SampleLog::version) too, as a
+    // resumed test appends to its file
+    static const uint8_t magic = 'J';
+    static const uint8_t version = 2;
+
+    // Maximum number of slots
+    static const unsigned int nSlotsMax = 16;
+
+    // Number of records after which the journal is compacted
+    static const unsigned int nRecordsMax = 256;
+
+
+private:
+
+    // Private class data
+
+        // File name of the journal
+        const char* const name_;
+
+        // The journal was scanned
+        bool scanned_;
+
+        // Number of records in the journal, -1 if the file is not aligned
+        long n_;
+
+        // Latest record of each slot and whether it exists
+        Checkpoint latest_[nSlotsMax];
+        bool found_[nSlotsMax];
+
+
+    // Private Member Functions
+
+        // Return true if the record is valid
+        static bool valid(const Checkpoint&);
+
+        // Read the latest valid record of each slot into the cache, return
+        // the number of records (-1 if the file is not aligned)
+        long scan();
+
+        // Scan the journal if not done yet (file system started)
+        void load();
+
+        // Write the latest record of each slot into a new journal
+        bool compact();
+
+
+public:
+
+    // Constructor
+    Journal();
+
+    // Destructor
+    ~Journal();
+
+
+    // Public Member Functions
+
+        // Append the checkpoint of a slot
+        bool write(Checkpoint&);
+
+        // Read the latest checkpoint of the slot, return false if none
+        bool read(const uint8_t, Checkpoint&);
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
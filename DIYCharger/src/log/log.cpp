@@ -0,0 +1,137 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "log.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const uint16_t Log::ringSize;
+const uint16_t Log::lineSize;
+
+
+// * * * * * * * * * * * * * * * Global Objects  * * * * * * * * * * * * * * //
+
+Log logger(Serial);
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Log::Log(HardwareSerial& out)
+:
+    out_(out),
+    tail_(0),
+    n_(0),
+    length_(0),
+    lines_(0),
+    dropped_(0)
+{}
+
+
+Log::~Log()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+void Log::commit()
+{
+    if (!length_)
+    {
+        return;
+    }
+
+    if (n_ + length_ > ringSize)
+    {
+        ++dropped_;
+    }
+    else
+    {
+        uint16_t head = (tail_ + n_) % ringSize;
+
+        for (uint16_t i = 0; i < length_; ++i)
+        {
+            ring_[head] = line_[i];
+            head = (head + 1) % ringSize;
+        }
+
+        n_ += length_;
+        ++lines_;
+    }
+
+    length_ = 0;
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+size_t Log::write(const uint8_t c)
+{
+    line_[length_++] = c;
+
+    // A line longer than the buffer is committed in pieces
+    if (c == '\n' || length_ == lineSize)
+    {
+        commit();
+    }
+
+    return 1;
+}
+
+
+void Log::pump()
+{
+    int room = out_.availableForWrite();
+
+    while (room > 0 && n_)
+    {
+        // Contiguous part of the ring
+        uint16_t n = ringSize - tail_ < n_ ? ringSize - tail_ : n_;
+
+        if (n > uint16_t(room))
+        {
+            n = uint16_t(room);
+        }
+
+        out_.write(ring_ + tail_, n);
+
+        tail_ = (tail_ + n) % ringSize;
+        n_ -= n;
+        room -= n;
+    }
+}
+
+
+void Log::flush()
+{
+    commit();
+
+    while (n_)
+    {
+        const uint16_t n = ringSize - tail_ < n_ ? ringSize - tail_ : n_;
+
+        out_.write(ring_ + tail_, n);
+
+        tail_ = (tail_ + n) % ringSize;
+        n_ -= n;
+    }
+}
+
+
+void Log::report(Print& out) const
+{
+    out << "# Log lines: " << lines_ << ", dropped: " << dropped_
+        << ", pending: " << n_ << " B" << endl;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,165 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Level-filtered serial logging without blocking the measurement. The
+    messages are collected line by line and copied into a TX ring buffer;
+    a task (see Log::pump) moves as many bytes to the UART as its FIFO takes
+    without waiting. If the ring is full, the whole line is dropped and
+    counted instead of stalling the caller.
+
+    The level is chosen at compile time (LOGLEVEL, default LOGINFO). The
+    macros LOGE, LOGW, LOGI and LOGD of the disabled levels expand to dead
+    code: the arguments are type-checked but never evaluated, and the
+    compiler removes the code:
+
+        LOGD(" ++ T = " << Format::Fixed(T, 2) << endl);
+
+    Reports are written into the ring in parts by the serial task, each
+    part when the ring is empty, hence no report line is dropped. Long
+    output (raw samples, file content) is paced by the serial task behind
+    the ring. Log::flush blocks and is kept for fatal errors only.
+
+SourceFiles
+    log.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef log_h
+#define log_h
+
+#include <Arduino.h>
+#include <Streaming.h>
+
+// * * * * * * * * * * * * * * * * Definitions  * * * * * * * * * * * * * * //
+
+#define LOGNONE 0
+#define LOGERROR 1
+#define LOGWARNING 2
+#define LOGINFO 3
+#define LOGDEBUG 4
+
+// Messages with a higher level are removed at compile time
+#ifndef LOGLEVEL
+    #define LOGLEVEL LOGINFO
+#endif
+
+
+/*---------------------------------------------------------------------------*\
+                             Class Log Declaration
+\*---------------------------------------------------------------------------*/
+
+class Log
+:
+    public Print
+{
+public:
+
+    // Size of the TX ring buffer and of the line buffer (bytes)
+    static const uint16_t ringSize = 1024;
+    static const uint16_t lineSize = 96;
+
+
+private:
+
+    // Private class data
+
+        // Serial interface
+        HardwareSerial& out_;
+
+        // TX ring buffer (read at tail_, n_ bytes used)
+        uint8_t ring_[ringSize];
+        uint16_t tail_;
+        uint16_t n_;
+
+        // Line in progress
+        uint8_t line_[lineSize];
+        uint16_t length_;
+
+        // Number of committed and dropped lines
+        unsigned long lines_;
+        unsigned long dropped_;
+
+
+    // Private Member Functions
+
+        // Copy the line into the ring or drop it if it does not fit
+        void commit();
+
+
+public:
+
+    // Constructor
+    Log(HardwareSerial&);
+
+    // Destructor
+    ~Log();
+
+
+    // Public Return Functions
+
+        // Return the number of bytes waiting in the ring
+        inline uint16_t pending() const { return n_; }
+
+        // Return the number of dropped lines
+        inline unsigned long dropped() const { return dropped_; }
+
+
+    // Public Member Functions
+
+        // Collect the character, a newline commits the line
+        using Print::write;
+        size_t write(const uint8_t);
+
+        // Move the bytes the UART accepts without waiting
+        void pump();
+
+        // Write everything (blocking)
+        void flush();
+
+        // Print the number of lines and drops
+        void report(Print&) const;
+};
+
+extern Log logger;
+
+
+// * * * * * * * * * * * * * * * * Log Macros  * * * * * * * * * * * * * * * //
+
+#if LOGLEVEL >= LOGERROR
+    #define LOGE(x) do { logger << x; } while (0)
+#else
+    #define LOGE(x) do { if (false) { logger << x; } } while (0)
+#endif
+
+#if LOGLEVEL >= LOGWARNING
+    #define LOGW(x) do { logger << x; } while (0)
+#else
+    #define LOGW(x) do { if (false) { logger << x; } } while (0)
+#endif
+
+#if LOGLEVEL >= LOGINFO
+    #define LOGI(x) do { logger << x; } while (0)
+#else
+    #define LOGI(x) do { if (false) { logger << x; } } while (0)
+#endif
+
+#if LOGLEVEL >= LOGDEBUG
+    #define LOGD(x) do { logger << x; } while (0)
+#else
+    #define LOGD(x) do { if (false) { logger << x; } } while (0)
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
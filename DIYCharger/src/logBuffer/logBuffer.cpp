@@ -0,0 +1,74 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <string.h>
+#include "logBuffer.h"
+#include "../hal/hal.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const uint16_t LogBuffer::pageSize;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+LogBuffer::LogBuffer(const unsigned long maxAge)
+:
+    n_(0),
+    tFirst_(0),
+    maxAge_(maxAge)
+{}
+
+
+LogBuffer::~LogBuffer()
+{}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void LogBuffer::append(const uint8_t* record, const size_t n)
+{
+    if (!fits(n))
+    {
+        return;
+    }
+
+    if (n_ == 0)
+    {
+        tFirst_ = hal().millis();
+    }
+
+    memcpy(data_ + n_, record, n);
+    n_ += n;
+}
+
+
+bool LogBuffer::expired() const
+{
+    return n_ && hal().millis() - tFirst_ >= maxAge_;
+}
+
+
+bool LogBuffer::due(const size_t n) const
+{
+    return n_ && (!fits(n) || expired());
+}
+
+
+void LogBuffer::clear()
+{
+    n_ = 0;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,108 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Write-behind buffer for the measurement records of one slot. The records
+    are collected in RAM and committed to the flash in chunks of (at most)
+    one flash page. To bound the data lost on a power failure or a reset,
+    the buffer is also due if its oldest record exceeds the maximum age;
+    the owner checks the age periodically (see WriterReader::flushExpired),
+    hence the partial page of a quiet slot does not wait for its next
+    record.
+
+SourceFiles
+    logBuffer.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef logBuffer_h
+#define logBuffer_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class LogBuffer Declaration
+\*---------------------------------------------------------------------------*/
+
+class LogBuffer
+{
+public:
+
+    // Flash page size of the LittleFS (bytes)
+    static const uint16_t pageSize = 256;
+
+
+private:
+
+    // Private class data
+
+        // Buffered data
+        uint8_t data_[pageSize];
+
+        // Number of buffered bytes
+        uint16_t n_;
+
+        // Time of the oldest buffered record (ms)
+        unsigned long tFirst_;
+
+        // Maximum age of a buffered record (ms)
+        unsigned long maxAge_;
+
+
+public:
+
+    // Constructor
+    LogBuffer(const unsigned long);
+
+    // Destructor
+    ~LogBuffer();
+
+
+    // Public Return Functions
+
+        // Return the buffered data
+        inline const uint8_t* data() const { return data_; }
+
+        // Return the number of buffered bytes
+        inline uint16_t size() const { return n_; }
+
+        // Return true if nothing is buffered
+        inline bool empty() const { return n_ == 0; }
+
+        // Return true if a record of the given size fits into the buffer
+        inline bool fits(const size_t n) const { return n_ + n <= pageSize; }
+
+
+    // Public Member Functions
+
+        // Append a record, it has to fit into the buffer
+        void append(const uint8_t*, const size_t);
+
+        // Return true if the oldest buffered record is too old
+        bool expired() const;
+
+        // Return true if the buffer has to be committed, i.e., no further
+        // record of the given size fits or the oldest record is too old
+        bool due(const size_t) const;
+
+        // Remove all buffered data
+        void clear();
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
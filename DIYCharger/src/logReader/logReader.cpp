@@ -0,0 +1,281 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "logReader.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const uint16_t LogReader::chunkSize;
+const uint16_t LogReader::lineSize;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+LogReader::LogReader()
+:
+    fileName_{},
+    format_(NONE),
+    summary_(SampleLog::summary()),
+    part_(RECORDS),
+    line_(0),
+    comment_(0),
+    begin_(0),
+    pos_(0),
+    end_(0),
+    bufferPos_(0),
+    bufferEnd_(0),
+    tFrom_(0),
+    tTo_(0xFFFFFFFFUL)
+{}
+
+
+LogReader::~LogReader()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+uint16_t LogReader::read(File& f)
+{
+    // Whole records only
+    const uint16_t step = format_ == BINARY ? header_.recordSize : 1;
+
+    uint32_t n = (chunkSize/step)*step;
+
+    if (n > end_ - pos_)
+    {
+        n = end_ - pos_;
+    }
+
+    if (!f.seek(pos_))
+    {
+        return 0;
+    }
+
+    return f.read(chunk_, n);
+}
+
+
+bool LogReader::header(Print& out, size_t& budget)
+{
+    // The comment area of version 1 is text, read through the chunk buffer
+    // (no records are buffered yet)
+    if (part_ == COMMENT)
+    {
+        if (comment_ < begin_ && budget && startFS())
+        {
+            uint32_t n = begin_ - comment_;
+
+            n = n < chunkSize ? n : chunkSize;
+            n = n < budget ? n : budget;
+
+            File f = openFile(fileName_);
+            n = f && f.seek(comment_) ? f.read(chunk_, n) : 0;
+
+            f.close();
+
+            stopFS();
+
+            out.write(chunk_, n);
+            budget -= n;
+
+            // File shrunk or vanished
+            comment_ = n ? comment_ + n : begin_;
+        }
+
+        if (comment_ < begin_)
+        {
+            return false;
+        }
+
+        part_ = LABELS;
+        line_ = 0;
+    }
+
+    while (part_ != RECORDS && budget >= lineSize)
+    {
+        const bool printed =
+            part_ == SUMMARY
+          ? SampleLog::printSummary(out, summary_, line_)
+          : SampleLog::printLabels(out, header_, line_);
+
+        if (printed)
+        {
+            ++line_;
+            budget -= lineSize;
+        }
+        else
+        {
+            part_ = part_ == SUMMARY ? LABELS : RECORDS;
+            line_ = 0;
+        }
+    }
+
+    return part_ == RECORDS;
+}
+
+
+uint32_t LogReader::t(const uint8_t* record) const
+{
+    return uint32_t(SampleLog::value(header_, record, 0));
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+bool LogReader::open(const char* fileName)
+{
+    strncpy(fileName_, fileName, nameSize - 1);
+    fileName_[nameSize - 1] = '\0';
+    format_ = NONE;
+    part_ = RECORDS;
+    line_ = 0;
+    begin_ = pos_ = end_ = 0;
+    bufferPos_ = bufferEnd_ = 0;
+    tFrom_ = 0;
+    tTo_ = 0xFFFFFFFFUL;
+
+    if (!startFS())
+    {
+        return false;
+    }
+
+    if (fileExist(fileName_))
+    {
+        File f = openFile(fileName_);
+        const uint32_t size = f.size();
+
+        const bool binary =
+            f.read(reinterpret_cast<uint8_t*>(&header_), sizeof(header_))
+         == sizeof(header_)
+         && SampleLog::valid(header_)
+         && header_.recordSize <= chunkSize;
+
+        if (binary)
+        {
+            format_ = BINARY;
+            begin_ = header_.summaryOffset + header_.summarySize;
+
+            part_ = header_.version > 1 ? SUMMARY : COMMENT;
+            comment_ = header_.summaryOffset;
+
+            // The version 1 comment area is shown as text
+            if (header_.version > 1)
+            {
+                f.seek(header_.summaryOffset);
+                f.read
+                (
+                    reinterpret_cast<uint8_t*>(&summary_),
+                    header_.summarySize < sizeof(summary_)
+                  ? header_.summarySize
+                  : sizeof(summary_)
+                );
+            }
+
+            // Ignore a torn record at the end
+            end_ =
+                size > begin_
+              ? begin_ + (size - begin_)/header_.recordSize*header_.recordSize
+              : begin_;
+        }
+        else
+        {
+            format_ = TEXT;
+            end_ = size;
+        }
+
+        pos_ = begin_;
+
+        f.close();
+    }
+
+    stopFS();
+
+    return format_ != NONE;
+}
+
+
+void LogReader::timeRange(const uint32_t tFrom, const uint32_t tTo)
+{
+    tFrom_ = tFrom;
+    tTo_ = tTo;
+}
+
+
+bool LogReader::next(Print& out, size_t budget)
+{
+    if (format_ == NONE)
+    {
+        return false;
+    }
+
+    if (!header(out, budget))
+    {
+        return true;
+    }
+
+    // Next chunk, one file open per chunk
+    if (bufferPos_ == bufferEnd_ && !done() && startFS())
+    {
+        File f = openFile(fileName_);
+        const uint16_t n = f ? read(f) : 0;
+
+        f.close();
+
+        stopFS();
+
+        if (!n)
+        {
+            // File shrunk or vanished
+            pos_ = end_;
+        }
+
+        bufferPos_ = 0;
+        bufferEnd_ = n;
+        pos_ += n;
+    }
+
+    if (format_ == TEXT)
+    {
+        const size_t rest = bufferEnd_ - bufferPos_;
+        const size_t n = rest < budget ? rest : budget;
+
+        out.write(chunk_ + bufferPos_, n);
+        bufferPos_ += n;
+    }
+    else
+    {
+        while (bufferPos_ < bufferEnd_ && budget >= lineSize)
+        {
+            const uint8_t* record = chunk_ + bufferPos_;
+
+            if (SampleLog::isSeparator(record, header_.recordSize))
+            {
+                SampleLog::printLine(out, '-');
+                budget -= lineSize;
+            }
+            else if (t(record) >= tFrom_ && t(record) <= tTo_)
+            {
+                SampleLog::print(out, header_, record);
+                budget -= lineSize;
+            }
+
+            bufferPos_ += header_.recordSize;
+        }
+    }
+
+    return !done();
+}
+
+
+// ************************************************************************* //
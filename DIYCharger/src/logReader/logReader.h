@@ -0,0 +1,162 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Streaming reader of a measurement file. The file is read in chunks of
+    one flash page into a fixed buffer and converted to text chunk by chunk,
+    hence the RAM needed does not depend on the size of the file.
+
+    The reader keeps the position in the file and the records of the actual
+    chunk which are not printed yet between two calls; the file is opened
+    only to read the next chunk. Thus the output can be paused after each
+    line of the header and each record (e.g., as soon as the UART would
+    block) and resumed later, even if the file system was unmounted in
+    between. The output can be restricted to a time range (ms since the
+    start of the phase); records outside are skipped without output.
+
+    Text files of older versions are streamed unchanged.
+
+SourceFiles
+    logReader.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef logReader_h
+#define logReader_h
+
+#include "../filesystem/filesystem.h"
+#include "../sampleLog/sampleLog.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class LogReader Declaration
+\*---------------------------------------------------------------------------*/
+
+class LogReader
+:
+    public FileSystem
+{
+public:
+
+    // Size of the chunk buffer (bytes)
+    static const uint16_t chunkSize = 256;
+
+    // Maximum length of the text line of a record (the separator line)
+    static const uint16_t lineSize = 82;
+
+    // Layout of the opened file
+    enum format { NONE, TEXT, BINARY };
+
+    // Part of the file which is printed next
+    enum part { COMMENT, SUMMARY, LABELS, RECORDS };
+
+
+private:
+
+    // Private class data
+
+        // Name of the file
+        char fileName_[nameSize];
+
+        // Layout of the file
+        enum format format_;
+
+        // Header and summary of a binary file
+        SampleLogHeader header_;
+        SampleLogSummary summary_;
+
+        // Part which is printed next, its next line and the next byte of
+        // the version 1 comment area
+        enum part part_;
+        uint8_t line_;
+        uint32_t comment_;
+
+        // Position of the first record, the next chunk and the end of the
+        // records (bytes)
+        uint32_t begin_;
+        uint32_t pos_;
+        uint32_t end_;
+
+        // Range of the chunk buffer which is not printed yet (bytes)
+        uint16_t bufferPos_;
+        uint16_t bufferEnd_;
+
+        // Time range of the records to be shown (ms)
+        uint32_t tFrom_;
+        uint32_t tTo_;
+
+        // Chunk buffer
+        uint8_t chunk_[chunkSize];
+
+
+    // Private Member Functions
+
+        // Read the next chunk at the position of the file, return the
+        // number of bytes (whole records only)
+        uint16_t read(File&);
+
+        // Print the next lines of the header as long as they fit into the
+        // budget (bytes, reduced), return true if the header is complete
+        bool header(Print&, size_t&);
+
+        // Return the time of the record (ms)
+        uint32_t t(const uint8_t*) const;
+
+
+public:
+
+    // Constructor
+    LogReader();
+
+    // Destructor
+    ~LogReader();
+
+
+    // Public Return Functions
+
+        // Return the layout of the file
+        inline enum format layout() const { return format_; }
+
+        // Return the position of the next record to be printed (bytes)
+        inline uint32_t position() const
+        {
+            return pos_ - (bufferEnd_ - bufferPos_);
+        }
+
+        // Return true if all records are shown
+        inline bool done() const
+        {
+            return pos_ >= end_ && bufferPos_ == bufferEnd_;
+        }
+
+
+    // Public Member Functions
+
+        // Open the file and read the header, return false if the file
+        // is not available
+        bool open(const char*);
+
+        // Show only records in the time range (ms)
+        void timeRange(const uint32_t, const uint32_t);
+
+        // Print the next lines of the header (summary and column labels)
+        // and records as long as their text fits into the budget (bytes,
+        // at most one chunk is read), return true if further lines follow
+        bool next(Print&, size_t);
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
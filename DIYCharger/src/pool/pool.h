@@ -0,0 +1,95 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Static pool of N objects. The memory of all objects is reserved at
+    compile time (no heap, no fragmentation), the objects are constructed
+    in place when the sketch creates them (e.g., in setup() when the
+    hardware is ready). The objects live until the board is reset, hence
+    they are never destroyed.
+
+SourceFiles
+    pool.h
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef pool_h
+#define pool_h
+
+#include <new>
+#include <utility>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                             Class Pool Declaration
+\*---------------------------------------------------------------------------*/
+
+template<class T, unsigned int N>
+class Pool
+{
+    // Private class data
+
+        // Memory of the objects
+        alignas(T) unsigned char data_[N][sizeof(T)];
+
+        // Constructed objects (nullptr if not constructed)
+        T* objects_[N];
+
+
+public:
+
+    // Constructor
+    Pool()
+    :
+        objects_{}
+    {}
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+
+    // Public Return Functions
+
+        // Return the number of objects
+        static constexpr unsigned int size() { return N; }
+
+        // Return the object i (nullptr if not constructed)
+        inline T* operator[](const unsigned int i) const
+        {
+            return i < N ? objects_[i] : nullptr;
+        }
+
+
+    // Public Member Functions
+
+        // Construct the object i with the arguments, return nullptr if it
+        // exists already
+        template<class... Args>
+        T* create(const unsigned int i, Args&&... args)
+        {
+            if (i >= N || objects_[i])
+            {
+                return nullptr;
+            }
+
+            objects_[i] = new (data_[i]) T(std::forward<Args>(args)...);
+
+            return objects_[i];
+        }
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,180 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Compile-time configuration of the tested cells and of the board. A cell
+    profile holds the voltage limits, the temperature range and the
+    parameters of the end-of-charge detection and of the fast screening; a
+    board profile holds the ADC calibration, the oversampling and the
+    discharge resistance. Profile<Cell, Board> combines both and derives
+    all constants at compile time, e.g., the voltage limits in mV, which
+    each slot converts once into raw ADC counts with its calibration (see
+    calibration.h), hence the state machine compares the raw counts
+    without any float operation. The profile is the template parameter of
+    Battery.
+
+    Other cells or boards are set up by a struct with the same members,
+    e.g.,
+
+        struct LiFePO4 : public Li18650
+        {
+            static constexpr float UCutOff = 2.50f;
+            static constexpr float UFull = 3.55f;
+        };
+
+SourceFiles
+    profile.h
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef profile_h
+#define profile_h
+
+#include <stdint.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Struct Li18650 Declaration
+\*---------------------------------------------------------------------------*/
+
+// Li-ion cell of type 18650
+struct Li18650
+{
+    // Below this voltage the slot is empty (V)
+    static constexpr float UEmpty = 0.5f;
+
+    // End of the discharge (V)
+    static constexpr float UCutOff = 2.60f;
+
+    // Minimum voltage of a full cell (V)
+    static constexpr float UFull = 4.10f;
+
+    // Allowed cell temperature (dC)
+    static constexpr float TMin = 5;
+    static constexpr float TMax = 28;
+
+    // A discharge pauses this margin below TMax, it starts again below
+    // twice the margin (dC); a cell fails at TMax after the maximum number
+    // of pauses
+    static constexpr float TPause = 1;
+    static constexpr unsigned int nPausesMax = 3;
+
+    // End-of-charge detection: window (s), maximum slope of the plateau
+    // (mV/min), maximum standard deviation (mV), minimum drop after the CV
+    // phase (mV) and timeout (min)
+    static constexpr unsigned int eocWindow = 120;
+    static constexpr int eocSlopeMax = 2;
+    static constexpr int eocSdMax = 3;
+    static constexpr int eocDropMin = 4;
+    static constexpr unsigned int eocTimeout = 300;
+
+    // Fast screening: settle time with charger, discharge pulse and recovery
+    // time with charger (s), minimum voltage under load (V), maximum pulse
+    // resistance (Ohm) and maximum recovery difference (V)
+    static constexpr unsigned int screenSettle = 2;
+    static constexpr unsigned int screenPulse = 3;
+    static constexpr unsigned int screenRecover = 5;
+    static constexpr float screenUMin = 2.5f;
+    static constexpr float screenRMax = 0.5f;
+    static constexpr float screenDURecovery = 0.05f;
+
+    // Compression of the measurement file: error bound of the voltage (V)
+    // and of the current (mA) of the interpolation between two records
+    static constexpr float logError[2] = { 0.005f, 1.5f };
+};
+
+
+/*---------------------------------------------------------------------------*\
+                         Struct WemosD1Mini Declaration
+\*---------------------------------------------------------------------------*/
+
+// Wemos D1 mini with the voltage divider at A0 and the discharge resistor
+struct WemosD1Mini
+{
+    // ADC calibration, the counts at the calibration voltage (V), the
+    // characteristic is linear through zero (default of the slots without
+    // a calibration table)
+    static constexpr uint16_t countsCal = 794;
+    static constexpr float UCal = 3.2835f;
+
+    // Maximum and minimum number of averaged ADC samples, target standard
+    // error of a voltage reading (V) and outlier rejection (trimmed mean).
+    // A reading takes as few of the latest samples as the measured noise
+    // allows, near the voltage limits always the maximum
+    static constexpr unsigned int overSampling = 20;
+    static constexpr unsigned int overSamplingMin = 4;
+    static constexpr float USigma = 0.002f;
+    static constexpr bool trim = false;
+
+    // Discharge resistance (Ohm)
+    static constexpr float RLoad = 3.3f;
+
+    // Power drawn from the supply by the charger module of a slot (W)
+    static constexpr float PCharge = 5.0f;
+};
+
+
+/*---------------------------------------------------------------------------*\
+                             Struct Profile Declaration
+\*---------------------------------------------------------------------------*/
+
+template<class Cell, class Board>
+struct Profile
+{
+    typedef Cell cell;
+    typedef Board board;
+
+    // Voltage limits (mV)
+    static constexpr int32_t UEmpty = int32_t(Cell::UEmpty*1000 + 0.5f);
+    static constexpr int32_t UCutOff = int32_t(Cell::UCutOff*1000 + 0.5f);
+
+    // Target standard error of a reading and half width of the band around
+    // the voltage limits with the full oversampling (1/16 counts)
+    static constexpr uint32_t sigmaQ4 =
+        uint32_t(Board::USigma*16*Board::countsCal/Board::UCal + 0.5f);
+    static constexpr uint32_t guardQ4 = 8*sigmaQ4;
+
+    // Voltage of one ADC count (mV, Q16 fixed point)
+    static constexpr int64_t mVPerCountQ16 =
+        int64_t(65536*1000*Board::UCal/Board::countsCal + 0.5f);
+
+    // Conductance of the discharge resistance (uA per mV, Q16 fixed point)
+    static constexpr int64_t G = int64_t(65536*1000/Board::RLoad + 0.5f);
+
+    // Minimum voltage of a full cell (mV)
+    static constexpr int32_t UFull = int32_t(Cell::UFull*1000 + 0.5f);
+
+    // Heat of the discharge resistance at the start of a discharge (W)
+    static constexpr float PDischarge = Cell::UFull*Cell::UFull/Board::RLoad;
+
+    static_assert(Board::overSampling > 0, "No ADC samples");
+    static_assert
+    (
+        Board::overSamplingMin > 0
+     && Board::overSamplingMin <= Board::overSampling,
+        "Minimum oversampling out of range"
+    );
+    static_assert(UCutOff > UEmpty, "Cut-off voltage below empty slot");
+    static_assert(Cell::TMin < Cell::TMax, "Empty temperature range");
+    static_assert
+    (
+        Cell::TPause > 0 && Cell::TMax - 2*Cell::TPause > Cell::TMin,
+        "Pause margin out of range"
+    );
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
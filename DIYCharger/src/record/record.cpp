@@ -0,0 +1,60 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "record.h"
+
+// * * * * * * * * * * * * * Public Static Functions * * * * * * * * * * * * //
+
+long Record::toFixed
+(
+    const float x,
+    const float scale,
+    const long lo,
+    const long hi
+)
+{
+    const float v = x*scale;
+
+    if (v <= lo)
+    {
+        return lo;
+    }
+
+    if (v >= hi)
+    {
+        return hi;
+    }
+
+    return long(v + (v < 0 ? -0.5f : 0.5f));
+}
+
+
+uint16_t Record::crc(const uint8_t* data, const size_t n)
+{
+    uint16_t c = 0xFFFF;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        c ^= uint16_t(data[i]) << 8;
+
+        for (uint8_t k = 0; k < 8; ++k)
+        {
+            c = c & 0x8000 ? (c << 1) ^ 0x1021 : c << 1;
+        }
+    }
+
+    return c;
+}
+
+
+// ************************************************************************* //
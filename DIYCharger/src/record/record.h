@@ -0,0 +1,85 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Helpers of the binary records of the files (measurement file, journal,
+    catalog, calibration): the conversion of a float into its fixed-point
+    field and the CRC-16 of a record. A record ends with its CRC (uint16_t
+    crc as last member), hence seal() and valid() cover all bytes before.
+
+SourceFiles
+    record.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef record_h
+#define record_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Record Declaration
+\*---------------------------------------------------------------------------*/
+
+class Record
+{
+public:
+
+    // Public Static Functions
+
+        // Scale, round and saturate the value to the given range
+        static long toFixed
+        (
+            const float,
+            const float,
+            const long,
+            const long
+        );
+
+        // Return the CRC-16 (CCITT) of the bytes
+        static uint16_t crc(const uint8_t*, const size_t);
+
+        // Return the CRC-16 of the record without its CRC
+        template<class T>
+        static uint16_t crc(const T& r)
+        {
+            return
+                crc
+                (
+                    reinterpret_cast<const uint8_t*>(&r),
+                    sizeof(r) - sizeof(r.crc)
+                );
+        }
+
+        // Set the CRC of the record
+        template<class T>
+        static void seal(T& r)
+        {
+            r.crc = crc(r);
+        }
+
+        // Return true if the CRC of the record matches
+        template<class T>
+        static bool valid(const T& r)
+        {
+            return r.crc == crc(r);
+        }
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,360 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <stddef.h>
+#include <string.h>
+#include "sampleLog.h"
+#include "../format/format.h"
+#include "../record/record.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const uint8_t SampleLog::version;
+const uint16_t SampleLog::summaryOffset;
+const uint16_t SampleLog::summarySize;
+const uint16_t SampleLog::dataOffset;
+
+
+// * * * * * * * * * * * * * * * Local Functions * * * * * * * * * * * * * * //
+
+namespace
+{
+    SampleLogField field
+    (
+        const char* label,
+        const uint8_t type,
+        const uint8_t offset,
+        const int8_t exponent,
+        const uint8_t decimals
+    )
+    {
+        SampleLogField f;
+
+        memset(f.label, 0, sizeof(f.label));
+        strncpy(f.label, label, sizeof(f.label) - 1);
+        f.type = type;
+        f.offset = offset;
+        f.exponent = exponent;
+        f.decimals = decimals;
+
+        return f;
+    }
+}
+
+
+// * * * * * * * * * * * * * * Public Static Functions * * * * * * * * * * * //
+
+SampleLogHeader SampleLog::header()
+{
+    SampleLogHeader h;
+
+    memcpy(h.magic, "DIYB", 4);
+    h.version = version;
+    h.nFields = 6;
+    h.recordSize = sizeof(SampleRecord);
+    h.reserved = 0;
+    h.headerSize = sizeof(SampleLogHeader);
+    h.summaryOffset = summaryOffset;
+    h.summarySize = summarySize;
+
+    h.fields[0] = field("t (s)", U32, offsetof(SampleRecord, t), -3, 2);
+    h.fields[1] = field("U (V)", U16, offsetof(SampleRecord, U), -4, 4);
+    h.fields[2] = field("I (mA)", U16, offsetof(SampleRecord, I), -1, 4);
+    h.fields[3] = field("P (mW)", U32, offsetof(SampleRecord, P), -2, 2);
+    h.fields[4] = field("C (mAh)", U32, offsetof(SampleRecord, C), -2, 2);
+    h.fields[5] = field("e (mWh)", U32, offsetof(SampleRecord, e), -2, 2);
+
+    return h;
+}
+
+
+bool SampleLog::valid(const SampleLogHeader& h)
+{
+    return
+        memcmp(h.magic, "DIYB", 4) == 0
+     && h.version >= 1
+     && h.version <= version
+     && h.nFields <= 6
+     && h.recordSize > 0;
+}
+
+
+SampleLogSummary SampleLog::summary()
+{
+    SampleLogSummary s;
+
+    memset(&s, 0, sizeof(s));
+
+    return s;
+}
+
+
+SampleLogSummary SampleLog::summary
+(
+    const uint32_t cellID,
+    const uint16_t nCycles,
+    const float U,
+    const float CAve,
+    const float eAve,
+    const uint32_t tStart,
+    const uint32_t tEnd
+)
+{
+    SampleLogSummary s = summary();
+
+    s.cellID = cellID;
+    s.nCycles = nCycles;
+    s.U = Record::toFixed(U, 1e3, 0, 0xFFFF);
+    s.CAve = Record::toFixed(CAve, 1e2, 0, 0x7FFFFFFFL);
+    s.eAve = Record::toFixed(eAve, 1e2, 0, 0x7FFFFFFFL);
+    s.tStart = tStart;
+    s.tEnd = tEnd;
+    s.flags = FINISHED;
+
+    return s;
+}
+
+
+SampleRecord SampleLog::encode
+(
+    const float t,
+    const float U,
+    const float I,
+    const float P,
+    const float C,
+    const float e
+)
+{
+    SampleRecord r;
+
+    r.t = Record::toFixed(t, 1e3, 0, 0x7FFFFFFFL);
+    r.U = Record::toFixed(U, 1e4, 0, 0xFFFF);
+    r.I = Record::toFixed(I, 1e1, 0, 0xFFFF);
+    r.P = Record::toFixed(P, 1e2, 0, 0x7FFFFFFFL);
+    r.C = Record::toFixed(C, 1e2, 0, 0x7FFFFFFFL);
+    r.e = Record::toFixed(e, 1e2, 0, 0x7FFFFFFFL);
+
+    return r;
+}
+
+
+SampleRecord SampleLog::separator()
+{
+    SampleRecord r;
+
+    memset(&r, 0xFF, sizeof(r));
+
+    return r;
+}
+
+
+bool SampleLog::isSeparator(const uint8_t* record, const uint8_t size)
+{
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        if (record[i] != 0xFF)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool SampleLog::printLabels
+(
+    Print& out,
+    const SampleLogHeader& h,
+    const uint8_t line
+)
+{
+    if (line > 2)
+    {
+        return false;
+    }
+
+    if (line != 1)
+    {
+        printLine(out, '=');
+        return true;
+    }
+
+    out.print("# ");
+
+    for (uint8_t i = 0; i < h.nFields; ++i)
+    {
+        // The label of a file is not necessarily null terminated
+        char label[sizeof(h.fields[i].label) + 1];
+        memcpy(label, h.fields[i].label, sizeof(h.fields[i].label));
+        label[sizeof(h.fields[i].label)] = '\0';
+
+        out.print(label);
+        out.print(i + 1 < h.nFields ? "\t" : "\n");
+    }
+
+    return true;
+}
+
+
+int64_t SampleLog::value
+(
+    const SampleLogHeader& h,
+    const uint8_t* record,
+    const uint8_t i
+)
+{
+    const SampleLogField& f = h.fields[i];
+    const uint8_t* p = record + f.offset;
+
+    int64_t raw = 0;
+
+    switch (f.type)
+    {
+        case U16:
+        {
+            uint16_t v;
+            memcpy(&v, p, sizeof(v));
+            raw = v;
+            break;
+        }
+        case I16:
+        {
+            int16_t v;
+            memcpy(&v, p, sizeof(v));
+            raw = v;
+            break;
+        }
+        case U32:
+        {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            raw = v;
+            break;
+        }
+        case I32:
+        {
+            int32_t v;
+            memcpy(&v, p, sizeof(v));
+            raw = v;
+            break;
+        }
+    }
+
+    return raw;
+}
+
+
+void SampleLog::print
+(
+    Print& out,
+    const SampleLogHeader& h,
+    const uint8_t* record
+)
+{
+    if (isSeparator(record, h.recordSize))
+    {
+        printLine(out, '-');
+        return;
+    }
+
+    for (uint8_t i = 0; i < h.nFields; ++i)
+    {
+        const SampleLogField& f = h.fields[i];
+
+        // Fixed-point value, printed without any float operation
+        Format::decimal(out, value(h, record, i), f.exponent, f.decimals);
+        out.print("\t");
+    }
+
+    out.print("\n");
+}
+
+
+bool SampleLog::printSummary
+(
+    Print& out,
+    const SampleLogSummary& s,
+    const uint8_t line
+)
+{
+    if (!(s.flags & FINISHED))
+    {
+        if (line)
+        {
+            return false;
+        }
+
+        out.print("# Test not finished\n");
+        return true;
+    }
+
+    switch (line)
+    {
+        case 0:
+            out.print("# Battery number: ");
+            Format::integer(out, s.cellID);
+            break;
+        case 1:
+            printLine(out, '-');
+            return true;
+        case 2:
+            out.print("# Voltage after last charging (V): ");
+            Format::decimal(out, s.U, -3, 2);
+            break;
+        case 3:
+            out.print("# Discharge cycles      : ");
+            Format::integer(out, s.nCycles);
+            break;
+        case 4:
+            out.print("# Average energy (mWh)  : ");
+            Format::decimal(out, s.eAve, -2, 2);
+            break;
+        case 5:
+            out.print("# Average capacity (mAh): ");
+            Format::decimal(out, s.CAve, -2, 2);
+            break;
+        case 6:
+            out.print("# Test duration (h)     : ");
+            Format::decimal
+            (
+                out,
+                int64_t(uint32_t(s.tEnd - s.tStart))/36000,
+                -2,
+                2
+            );
+            break;
+        default:
+            return false;
+    }
+
+    out.print("\n");
+
+    return true;
+}
+
+
+void SampleLog::printLine(Print& out, const char c)
+{
+    out.print('#');
+
+    for (unsigned int i = 0; i < 80; ++i)
+    {
+        out.print(c);
+    }
+
+    out.print('\n');
+}
+
+
+// ************************************************************************* //
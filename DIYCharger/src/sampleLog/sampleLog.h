@@ -0,0 +1,228 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Compact binary format of the measurement files. Each sample (t, U, I, P,
+    C, e) is stored as fixed-point record of 20 bytes instead of a text line
+    of about 50 bytes, with the resolution of the text layout. All values
+    are little endian.
+
+    File layout (version 3)
+        - SampleLogHeader (magic "DIYB", version, record size and one
+          descriptor per field: label, type, offset, decimal exponent of
+          the unit and the number of decimals for the text output)
+        - SampleLogSummary: fixed-size block with the results of the test
+          (cell ID, cycles, final voltage, averages, time stamps). It is
+          zero while the test runs and written once in place at the end,
+          hence finalizing costs one block write of constant size
+        - Records; a record with all bytes 0xFF is a horizontal line that
+          separates the charge and discharge phases
+
+    Version 1 files hold 8 padded text lines instead of the summary block;
+    they are still shown by the reader. Version 2 records stored P, C and e
+    in 16 bits (saturated at 6.5 W, 6553.5 mAh and 65535 mWh); the reader
+    shows them by the field descriptors of their header.
+
+    The reader converts the file back into the tab separated text layout
+    which was used before.
+
+SourceFiles
+    sampleLog.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef sampleLog_h
+#define sampleLog_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+// Description of a single field of the record
+struct __attribute__((packed)) SampleLogField
+{
+    // Label of the column in the text output, e.g., "U (V)"
+    char label[10];
+
+    // Storage type (see SampleLog::type)
+    uint8_t type;
+
+    // Offset of the field within the record (bytes)
+    uint8_t offset;
+
+    // Value = raw * 10^exponent
+    int8_t exponent;
+
+    // Number of decimals in the text output
+    uint8_t decimals;
+};
+
+
+// Header at the beginning of each measurement file
+struct __attribute__((packed)) SampleLogHeader
+{
+    char magic[4];
+    uint8_t version;
+    uint8_t nFields;
+    uint8_t recordSize;
+    uint8_t reserved;
+    uint16_t headerSize;
+    uint16_t summaryOffset;
+    uint16_t summarySize;
+    SampleLogField fields[6];
+};
+
+
+// Results of the test, stored behind the header
+struct __attribute__((packed)) SampleLogSummary
+{
+    // Running number of the cell (0 := not assigned yet)
+    uint32_t cellID;
+
+    // Number of discharge cycles
+    uint16_t nCycles;
+
+    // Voltage after the last charge (mV)
+    uint16_t U;
+
+    // Average capacity (0.01 mAh)
+    uint32_t CAve;
+
+    // Average energy (0.01 mWh)
+    uint32_t eAve;
+
+    // Start and end of the test, board clock (ms since boot, no RTC)
+    uint32_t tStart;
+    uint32_t tEnd;
+
+    // State of the summary (see SampleLog::summaryFlags)
+    uint8_t flags;
+    uint8_t reserved[3];
+};
+
+
+// One sample
+struct __attribute__((packed)) SampleRecord
+{
+    // Time (ms)
+    uint32_t t;
+
+    // Voltage (0.1 mV)
+    uint16_t U;
+
+    // Current (0.1 mA)
+    uint16_t I;
+
+    // Power (0.01 mW)
+    uint32_t P;
+
+    // Capacity (0.01 mAh), includes the charge phases
+    uint32_t C;
+
+    // Energy (0.01 mWh)
+    uint32_t e;
+};
+
+
+/*---------------------------------------------------------------------------*\
+                           Class SampleLog Declaration
+\*---------------------------------------------------------------------------*/
+
+class SampleLog
+{
+public:
+
+    // Storage types of the fields
+    enum type { U16, I16, U32, I32 };
+
+    // State of the summary block
+    enum summaryFlags { FINISHED = 1 };
+
+    // Format version
+    static const uint8_t version = 3;
+
+    // Position and size of the summary block (bytes)
+    static const uint16_t summaryOffset = sizeof(SampleLogHeader);
+    static const uint16_t summarySize = sizeof(SampleLogSummary);
+
+    // Position of the first record (bytes)
+    static const uint16_t dataOffset = summaryOffset + summarySize;
+
+
+    // Public Static Functions
+
+        // Return the header of the actual format version
+        static SampleLogHeader header();
+
+        // Check the header read from a file
+        static bool valid(const SampleLogHeader&);
+
+        // Return the summary of a running test (all fields zero)
+        static SampleLogSummary summary();
+
+        // Convert the results of a finished test into the summary
+        static SampleLogSummary summary
+        (
+            const uint32_t,
+            const uint16_t,
+            const float,
+            const float,
+            const float,
+            const uint32_t,
+            const uint32_t
+        );
+
+        // Convert the data into a record (saturated to the field ranges)
+        static SampleRecord encode
+        (
+            const float,
+            const float,
+            const float,
+            const float,
+            const float,
+            const float
+        );
+
+        // Return the separator record
+        static SampleRecord separator();
+
+        // Check if the record is a separator
+        static bool isSeparator(const uint8_t*, const uint8_t);
+
+        // Print the line of the column labels in the text layout, return
+        // false if there is none (82 bytes at most)
+        static bool printLabels(Print&, const SampleLogHeader&, const uint8_t);
+
+        // Return the raw value of the field of the record
+        static int64_t value
+        (
+            const SampleLogHeader&,
+            const uint8_t*,
+            const uint8_t
+        );
+
+        // Print the record in the text layout
+        static void print(Print&, const SampleLogHeader&, const uint8_t*);
+
+        // Print the line of the summary in the text layout, return false
+        // if there is none (82 bytes at most)
+        static bool printSummary(Print&, const SampleLogSummary&, const uint8_t);
+
+        // Print a horizontal line of 80 characters
+        static void printLine(Print&, const char);
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
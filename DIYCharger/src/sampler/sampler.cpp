@@ -0,0 +1,146 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include "sampler.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int Sampler::nMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Sampler::Sampler(const unsigned int overSampling)
+:
+    overSampling_(constrain(overSampling, 1u, nMax)),
+    head_(0),
+    n_(0),
+    sum_(0),
+    sumSq_(0)
+{}
+
+
+Sampler::~Sampler()
+{}
+
+
+// * * * * * * * * * * * * * Public Return Functions * * * * * * * * * * * * //
+
+unsigned int Sampler::needed
+(
+    const uint32_t targetQ4,
+    const unsigned int nMin
+) const
+{
+    if (n_ < 2 || !targetQ4 || nMin >= n_)
+    {
+        return n_;
+    }
+
+    // Standard error of k samples: var/k < target^2, with
+    // var = (n*sumSq - sum^2)/(n*(n - 1)) and the target in 1/16 counts
+    const uint64_t s2 = uint64_t(n_)*sumSq_ - uint64_t(sum_)*sum_;
+    const uint64_t t2 = uint64_t(n_)*(n_ - 1)*targetQ4*targetQ4;
+    const uint64_t k = (256*s2 + t2 - 1)/t2;
+
+    if (k <= nMin)
+    {
+        return nMin;
+    }
+
+    return k < n_ ? unsigned(k) : n_;
+}
+
+
+uint32_t Sampler::meanQ4(unsigned int k, const bool trim) const
+{
+    if (k > n_)
+    {
+        k = n_;
+    }
+
+    if (!k)
+    {
+        return 0;
+    }
+
+    // Walk backwards from the latest sample
+    uint32_t sum = 0;
+    uint16_t lo = 0xFFFF;
+    uint16_t hi = 0;
+    unsigned int i = head_;
+
+    for (unsigned int j = 0; j < k; ++j)
+    {
+        i = (i ? i : overSampling_) - 1;
+
+        const uint16_t v = buffer_[i];
+
+        sum += v;
+
+        if (v < lo)
+        {
+            lo = v;
+        }
+
+        if (v > hi)
+        {
+            hi = v;
+        }
+    }
+
+    if (trim && k > 4)
+    {
+        return ((sum - lo - hi) << 4)/(k - 2);
+    }
+
+    return (sum << 4)/k;
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void Sampler::add(const int raw)
+{
+    const uint16_t value = constrain(raw, 0, 1023);
+
+    // Ring buffer is full, remove the oldest sample
+    if (n_ == overSampling_)
+    {
+        sum_ -= buffer_[head_];
+        sumSq_ -= uint32_t(buffer_[head_])*buffer_[head_];
+    }
+    else
+    {
+        ++n_;
+    }
+
+    buffer_[head_] = value;
+    sum_ += value;
+    sumSq_ += uint32_t(value)*value;
+
+    head_ = (head_ + 1) % overSampling_;
+}
+
+
+void Sampler::reset()
+{
+    head_ = 0;
+    n_ = 0;
+    sum_ = 0;
+    sumSq_ = 0;
+}
+
+
+// ************************************************************************* //
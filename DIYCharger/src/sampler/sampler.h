@@ -0,0 +1,111 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Non-blocking oversampling of an analog input. The samples are read by
+    the acquisition engine (see acquisition.h) and added to the sampler.
+    The last n samples are kept in a ring buffer together with their sum,
+    hence the averaged value is available at any time in O(1).
+
+    The sum of the squares gives the variance of the samples, hence a
+    reader can take only as many of the latest samples as it needs for a
+    target standard error of the mean (a quiet signal needs a few, a noisy
+    one all). Outliers are rejected by a trimmed mean which drops the
+    lowest and the highest sample.
+
+SourceFiles
+    sampler.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef sampler_h
+#define sampler_h
+
+#include <stdint.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Sampler Declaration
+\*---------------------------------------------------------------------------*/
+
+class Sampler
+{
+public:
+
+    // Maximum number of samples which can be averaged
+    static const unsigned int nMax = 32;
+
+
+private:
+
+    // Private class data
+
+        // Number of samples to average
+        unsigned int overSampling_;
+
+        // Ring buffer of the raw ADC counts
+        uint16_t buffer_[nMax];
+
+        // Position of the next sample in the ring buffer
+        unsigned int head_;
+
+        // Number of valid samples in the ring buffer
+        unsigned int n_;
+
+        // Sum of all valid samples
+        uint32_t sum_;
+
+        // Sum of the squares of all valid samples
+        uint32_t sumSq_;
+
+
+public:
+
+    // Constructor (number of samples to average)
+    Sampler(const unsigned int);
+
+    // Destructor
+    ~Sampler();
+
+
+    // Public Return Functions
+
+        // Return the sum of the ADC counts of the averaged samples
+        inline uint32_t sum() const { return sum_; }
+
+        // Return how many samples are in the averaged value
+        inline unsigned int n() const { return n_; }
+
+        // Return the number of latest samples whose mean has a standard
+        // error below the target (1/16 counts), at least the given minimum
+        unsigned int needed(const uint32_t, const unsigned int) const;
+
+        // Return the mean of the latest k samples (1/16 counts), trimmed
+        // by the lowest and the highest sample if requested (k > 4)
+        uint32_t meanQ4(const unsigned int, const bool) const;
+
+
+    // Public Member Functions
+
+        // Add a sample (raw ADC counts)
+        void add(const int);
+
+        // Remove all samples
+        void reset();
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
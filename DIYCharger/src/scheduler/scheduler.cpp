@@ -0,0 +1,191 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "scheduler.h"
+#include "../log/log.h"
+#include "../hal/hal.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int Scheduler::nMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Scheduler::Scheduler()
+:
+    n_(0)
+{}
+
+
+Scheduler::~Scheduler()
+{}
+
+
+// * * * * * * * * * * * * * Public Setter Functions * * * * * * * * * * * * //
+
+int Scheduler::add
+(
+    const char* name,
+    const Function function,
+    const int arg,
+    const unsigned long period,
+    const unsigned long deadline
+)
+{
+    if (n_ == nMax)
+    {
+        LOGE
+        (
+            "ERROR: Scheduler is full, task '" << name << "' not added" << endl
+        );
+
+        return -1;
+    }
+
+    Task& task = tasks_[n_];
+
+    task.name = name;
+    task.function = function;
+    task.arg = arg;
+    task.period = 1000*period;
+    task.deadline = 1000*(deadline ? deadline : period);
+    task.due = hal().micros();
+    task.runs = 0;
+    task.misses = 0;
+    task.maxJitter = 0;
+    task.sumJitter = 0;
+    task.maxRunTime = 0;
+
+    return n_++;
+}
+
+
+void Scheduler::setPeriod(const int id, const unsigned long period)
+{
+    Task& task = tasks_[id];
+
+    // Keep the relative deadline
+    if (task.deadline == task.period)
+    {
+        task.deadline = 1000*period;
+    }
+
+    task.period = 1000*period;
+    task.due = hal().micros() + task.period;
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void Scheduler::run()
+{
+    for (unsigned int i = 0; i < n_; ++i)
+    {
+        Task& task = tasks_[i];
+
+        const unsigned long t = hal().micros();
+
+        // Signed difference handles the wrap around of micros()
+        if (long(t - task.due) < 0)
+        {
+            continue;
+        }
+
+        // Jitter statistics
+        const unsigned long jitter = t - task.due;
+
+        ++task.runs;
+        task.sumJitter += jitter;
+
+        if (jitter > task.maxJitter)
+        {
+            task.maxJitter = jitter;
+        }
+
+        if (jitter > task.deadline)
+        {
+            ++task.misses;
+        }
+
+        // Next due time (fixed rate), if we are more than one period late
+        // the missed runs are skipped
+        task.due += task.period;
+
+        if (long(t - task.due) > 0)
+        {
+            task.due = t + task.period;
+        }
+
+        task.function(task.arg);
+
+        const unsigned long runTime = hal().micros() - t;
+
+        if (runTime > task.maxRunTime)
+        {
+            task.maxRunTime = runTime;
+        }
+    }
+
+    // Wait for the next task
+    const unsigned long t = hal().micros();
+    long wait = 1000000;
+
+    for (unsigned int i = 0; i < n_; ++i)
+    {
+        const long dt = long(tasks_[i].due - t);
+
+        if (dt < wait)
+        {
+            wait = dt;
+        }
+    }
+
+    // Sleep the whole ms (the system runs meanwhile), busy-wait the rest,
+    // hence the next task starts within a few us of its due time
+    if (wait > 0)
+    {
+        hal().delay(wait/1000);
+
+        const long rest = wait - long(hal().micros() - t);
+
+        if (rest > 0)
+        {
+            hal().delayMicroseconds(rest);
+        }
+    }
+}
+
+
+void Scheduler::report(Print& out) const
+{
+    out << "# Task\tArg\tPeriod (ms)\tRuns\tMisses\t"
+        << "Jitter ave/max (us)\tRun time max (us)" << endl;
+
+    for (unsigned int i = 0; i < n_; ++i)
+    {
+        const Task& task = tasks_[i];
+
+        const unsigned long aveJitter =
+            task.runs ? (unsigned long)(task.sumJitter/task.runs) : 0;
+
+        out << task.name << "\t" << task.arg << "\t"
+            << task.period/1000 << "\t" << task.runs << "\t"
+            << task.misses << "\t" << aveJitter << "/" << task.maxJitter
+            << "\t" << task.maxRunTime << endl;
+    }
+}
+
+
+// ************************************************************************* //
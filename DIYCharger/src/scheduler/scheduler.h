@@ -0,0 +1,135 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Lightweight cooperative scheduler. Each task is a function with an
+    integer argument (e.g., the slot number), a period and a deadline. The
+    tasks must never block; a task that is due is simply called in the next
+    pass. Between the passes the scheduler waits until the next task is due.
+
+    For each task the jitter (start time - due time) and the run time are
+    tracked. A start later than the deadline counts as deadline miss.
+
+SourceFiles
+    scheduler.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef scheduler_h
+#define scheduler_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Scheduler Declaration
+\*---------------------------------------------------------------------------*/
+
+class Scheduler
+{
+public:
+
+    // Function that is called by the scheduler
+    typedef void (*Function)(const int);
+
+    // Maximum number of tasks
+    static const unsigned int nMax = 64;
+
+    // Task data and statistics
+    struct Task
+    {
+        // Task name (for the statistics)
+        const char* name;
+
+        // Function and its argument
+        Function function;
+        int arg;
+
+        // Period and allowed delay of the start (us)
+        unsigned long period;
+        unsigned long deadline;
+
+        // Next due time (us)
+        unsigned long due;
+
+        // Statistics
+        unsigned long runs;
+        unsigned long misses;
+        unsigned long maxJitter;
+        unsigned long long sumJitter;
+        unsigned long maxRunTime;
+    };
+
+
+private:
+
+    // Private class data
+
+        // Task table
+        Task tasks_[nMax];
+
+        // Number of tasks
+        unsigned int n_;
+
+
+public:
+
+    // Constructor
+    Scheduler();
+
+    // Destructor
+    ~Scheduler();
+
+
+    // Public Setter Functions
+
+        // Add a task (period and deadline in ms) and return its id, a
+        // deadline of 0 is equal to the period. Return -1 if the table is
+        // full
+        int add
+        (
+            const char*,
+            const Function,
+            const int,
+            const unsigned long,
+            const unsigned long deadline = 0
+        );
+
+        // Change the period (ms) of a task, the next run is one period
+        // after the actual time
+        void setPeriod(const int, const unsigned long);
+
+
+    // Public Return Functions
+
+        // Return the number of tasks
+        inline unsigned int size() const { return n_; }
+
+        // Return the task data
+        inline const Task& task(const int id) const { return tasks_[id]; }
+
+
+    // Public Member Functions
+
+        // Run all due tasks once and wait until the next task is due
+        void run();
+
+        // Print the statistics of all tasks
+        void report(Print&) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
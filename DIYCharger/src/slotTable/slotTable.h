@@ -0,0 +1,69 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Hot data of all slots as struct of arrays: mode, voltage, current,
+    capacity, energy and temperature. Each battery keeps its own state in
+    its row of the table, hence a sweep over all slots (e.g., the power or
+    thermal budget) reads contiguous memory instead of jumping through the
+    large battery objects. The table is allocated statically for the
+    maximum number of slots, hence its memory is known at compile time.
+    The names of the measurement files are kept here as well (fixed size,
+    no heap).
+
+SourceFiles
+    slotTable.h
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef slotTable_h
+#define slotTable_h
+
+#include <stdint.h>
+#include "../integrator/integrator.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                          Struct SlotTable Declaration
+\*---------------------------------------------------------------------------*/
+
+struct SlotTable
+{
+    // Maximum number of slots (16 channel multiplexer)
+    static const unsigned int nMax = 16;
+
+    // Mode of the slot (see Battery::mode)
+    uint8_t mode[nMax];
+
+    // Actual voltage (V)
+    float U[nMax];
+
+    // Actual current (uA)
+    int32_t I[nMax];
+
+    // Capacity (integral of I) and energy (integral of the power)
+    Integrator C[nMax];
+    Integrator e[nMax];
+
+    // Actual temperature (dC)
+    float T[nMax];
+
+    // Name of the measurement file ("slot_<n>")
+    char fileName[nMax][8];
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "swingingDoor.h"
+#include "../format/format.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int SwingingDoor::nChannels;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+SwingingDoor::SwingingDoor(const float* error, const unsigned long maxGap)
+:
+    maxGap_(maxGap),
+    tPivot_(0),
+    tPrevious_(0),
+    pivot_(false),
+    pending_(false),
+    offered_(0),
+    kept_(0)
+{
+    for (unsigned int i = 0; i < nChannels; ++i)
+    {
+        error_[i] = error[i];
+        yPivot_[i] = 0;
+        yPrevious_[i] = 0;
+        slopeMin_[i] = 0;
+        slopeMax_[i] = 0;
+    }
+}
+
+
+SwingingDoor::~SwingingDoor()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+void SwingingDoor::setPivot(const unsigned long t, const float* y)
+{
+    tPivot_ = t;
+
+    for (unsigned int i = 0; i < nChannels; ++i)
+    {
+        yPivot_[i] = y[i];
+        slopeMin_[i] = -INFINITY;
+        slopeMax_[i] = INFINITY;
+    }
+
+    pivot_ = true;
+    pending_ = false;
+}
+
+
+bool SwingingDoor::narrow(const unsigned long t, const float* y)
+{
+    const float dt = float(t - tPivot_);
+    bool open = true;
+
+    for (unsigned int i = 0; i < nChannels; ++i)
+    {
+        const float lo = (y[i] - error_[i] - yPivot_[i])/dt;
+        const float hi = (y[i] + error_[i] - yPivot_[i])/dt;
+
+        if (lo > slopeMin_[i])
+        {
+            slopeMin_[i] = lo;
+        }
+
+        if (hi < slopeMax_[i])
+        {
+            slopeMax_[i] = hi;
+        }
+
+        open = open && slopeMin_[i] <= slopeMax_[i];
+    }
+
+    return open;
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+enum SwingingDoor::keep SwingingDoor::add
+(
+    const unsigned long t,
+    const float* y
+)
+{
+    ++offered_;
+
+    enum keep k = NONE;
+
+    if (!pivot_)
+    {
+        // First record of the series
+        setPivot(t, y);
+        k = CURRENT;
+    }
+    else if (t == tPivot_)
+    {
+        return NONE;
+    }
+    else if (t - tPivot_ > maxGap_ || !narrow(t, y))
+    {
+        if (pending_)
+        {
+            // The previous record closes the gap or the doors, the doors
+            // open again at it
+            setPivot(tPrevious_, yPrevious_);
+            narrow(t, y);
+            k = PREVIOUS;
+        }
+        else
+        {
+            // The records are further apart than the maximum gap
+            setPivot(t, y);
+            k = CURRENT;
+        }
+    }
+
+    if (k != CURRENT)
+    {
+        tPrevious_ = t;
+
+        for (unsigned int i = 0; i < nChannels; ++i)
+        {
+            yPrevious_[i] = y[i];
+        }
+
+        pending_ = true;
+    }
+
+    if (k != NONE)
+    {
+        ++kept_;
+    }
+
+    return k;
+}
+
+
+void SwingingDoor::reset()
+{
+    pivot_ = false;
+    pending_ = false;
+}
+
+
+void SwingingDoor::report(Print& out) const
+{
+    const float ratio = offered_ ? 100.f*kept_/offered_ : 0;
+
+    out << "# Compression: " << kept_ << " of " << offered_
+        << " records kept (" << Format::Fixed(ratio, 1) << " %)" << endl;
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,132 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Online swinging-door compression of the measurement records. A record
+    is only kept if the straight line from the last kept record cannot
+    represent the records in between within the error bound of each
+    channel (here voltage and current). Starting at the last kept record
+    (the pivot), each offered record narrows the range of slopes which
+    pass all records within the bounds (the doors). If the range is empty,
+    the previous record is kept and becomes the new pivot. Furthermore,
+    the previous record is kept if the gap to the pivot would exceed the
+    maximum gap.
+
+    Hence, a flat phase is stored with a few records only, while the knee
+    of a discharge keeps every record the bounds ask for. The work per
+    record is O(1) and the state is a few numbers per channel.
+
+SourceFiles
+    swingingDoor.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef swingingDoor_h
+#define swingingDoor_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                        Class SwingingDoor Declaration
+\*---------------------------------------------------------------------------*/
+
+class SwingingDoor
+{
+public:
+
+    // Number of compressed channels
+    static const unsigned int nChannels = 2;
+
+    // Record(s) which have to be kept after an offer
+    enum keep { NONE, PREVIOUS, CURRENT };
+
+
+private:
+
+    // Private class data
+
+        // Error bound of each channel
+        float error_[nChannels];
+
+        // Maximum gap between two kept records (ms)
+        unsigned long maxGap_;
+
+        // Pivot (last kept record)
+        unsigned long tPivot_;
+        float yPivot_[nChannels];
+
+        // Previous offered record
+        unsigned long tPrevious_;
+        float yPrevious_[nChannels];
+
+        // Minimum and maximum slope through the pivot which passes all
+        // offered records within the bound (per ms)
+        float slopeMin_[nChannels];
+        float slopeMax_[nChannels];
+
+        // A pivot is set / the previous record is not kept
+        bool pivot_;
+        bool pending_;
+
+
+        // Statistics
+
+            // Number of offered and kept records
+            unsigned long offered_;
+            unsigned long kept_;
+
+
+    // Private Member Functions
+
+        // Set the record as pivot and open the doors
+        void setPivot(const unsigned long, const float*);
+
+        // Narrow the doors by the record, return false if they closed
+        bool narrow(const unsigned long, const float*);
+
+
+public:
+
+    // Constructor (error bound of each channel, maximum gap (ms))
+    SwingingDoor(const float*, const unsigned long);
+
+    // Destructor
+    ~SwingingDoor();
+
+
+    // Public Return Functions
+
+        // Return true if the previous record is not kept yet
+        inline bool pending() const { return pending_; }
+
+
+    // Public Member Functions
+
+        // Offer the record (time (ms), value of each channel), return
+        // which record has to be written
+        enum keep add(const unsigned long, const float*);
+
+        // Start a new series, the pending record is dropped (keep it
+        // first if needed) and the next record is kept
+        void reset();
+
+        // Print the number of offered and kept records
+        void report(Print&) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
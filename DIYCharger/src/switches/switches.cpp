@@ -0,0 +1,160 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Streaming.h>
+#include "switches.h"
+#include "../hal/hal.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int Switches::nMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+Switches::Switches
+(
+    const enum bus b,
+    const uint8_t* pins,
+    const unsigned int nSlots
+)
+:
+    bus_(b),
+    n_(nSlots < nMax ? nSlots : nMax),
+    state_(uint16_t((1ul << n_) - 1)),
+    output_(state_),
+    transactions_(0)
+{
+    const unsigned int nPins = bus_ == PINS ? n_ : 3;
+
+    for (unsigned int i = 0; i < nMax; ++i)
+    {
+        pins_[i] = i < nPins ? pins[i] : 0;
+    }
+}
+
+
+Switches::~Switches()
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+void Switches::shiftOut() const
+{
+    const uint8_t data = pins_[0];
+    const uint8_t clock = pins_[1];
+    const uint8_t latch = pins_[2];
+
+    // The last register of the chain takes the highest slots, hence the
+    // bits are shifted out from the highest slot (padded to full registers)
+    const unsigned int nBits = 8*((n_ + 7)/8);
+
+    hal().digitalWrite(latch, LOW);
+
+    for (unsigned int i = nBits; i-- > 0;)
+    {
+        hal().digitalWrite(data, (output_ >> i) & 1 ? HIGH : LOW);
+        hal().digitalWrite(clock, HIGH);
+        hal().digitalWrite(clock, LOW);
+    }
+
+    hal().digitalWrite(latch, HIGH);
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void Switches::begin()
+{
+    const unsigned int nPins = bus_ == PINS ? n_ : 3;
+
+    for (unsigned int i = 0; i < nPins; ++i)
+    {
+        hal().pinMode(pins_[i], OUTPUT);
+    }
+
+    if (bus_ == PINS)
+    {
+        for (unsigned int slot = 0; slot < n_; ++slot)
+        {
+            hal().digitalWrite(pins_[slot], output(slot) ? HIGH : LOW);
+        }
+    }
+    else
+    {
+        hal().digitalWrite(pins_[1], LOW);
+        shiftOut();
+    }
+
+    ++transactions_;
+}
+
+
+void Switches::charge(const unsigned int slot, const bool on)
+{
+    if (slot >= n_)
+    {
+        return;
+    }
+
+    if (on)
+    {
+        state_ |= uint16_t(1u << slot);
+    }
+    else
+    {
+        state_ &= uint16_t(~(1u << slot));
+    }
+}
+
+
+void Switches::apply()
+{
+    if (state_ == output_)
+    {
+        return;
+    }
+
+    const uint16_t changed = state_ ^ output_;
+
+    output_ = state_;
+
+    if (bus_ == PINS)
+    {
+        for (unsigned int slot = 0; slot < n_; ++slot)
+        {
+            if ((changed >> slot) & 1)
+            {
+                hal().digitalWrite(pins_[slot], output(slot) ? HIGH : LOW);
+            }
+        }
+    }
+    else
+    {
+        shiftOut();
+    }
+
+    ++transactions_;
+}
+
+
+void Switches::report(Print& out) const
+{
+    out << "# Switches: " << n_
+        << (bus_ == PINS ? " pins" : " shift register")
+        << ", transactions: " << transactions_ << endl;
+}
+
+
+// ************************************************************************* //
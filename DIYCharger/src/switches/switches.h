@@ -0,0 +1,123 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Charger / load switches of all slots. Each slot connects its cell either
+    to the charger (HIGH) or to the discharge resistor (LOW), independent of
+    the other slots.
+
+    The slots only set the requested state, the outputs are written once per
+    loop by apply() in a single bus transaction and only if a state changed.
+    The switches are driven either
+        - PINS:          one digital pin per slot (few slots)
+        - SHIFTREGISTER: cascaded 74HC595 shift registers, 8 slots each,
+                         the pins are data, clock and latch (the outputs
+                         of all slots change at the latch pulse together)
+
+SourceFiles
+    switches.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef switches_h
+#define switches_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                          Class Switches Declaration
+\*---------------------------------------------------------------------------*/
+
+class Switches
+{
+public:
+
+    // Maximum number of slots (16 channel multiplexer)
+    static const unsigned int nMax = 16;
+
+    // Wiring of the switches
+    enum bus { PINS, SHIFTREGISTER };
+
+
+private:
+
+    // Private class data
+
+        // Wiring of the switches
+        enum bus bus_;
+
+        // Pin of each slot (PINS) or data, clock and latch pin
+        // (SHIFTREGISTER)
+        uint8_t pins_[nMax];
+
+        // Number of slots
+        unsigned int n_;
+
+        // Requested and written state of all slots (bit i: slot i charges)
+        uint16_t state_;
+        uint16_t output_;
+
+        // Number of bus transactions
+        unsigned long transactions_;
+
+
+    // Private Member Functions
+
+        // Shift the state of all slots out and latch it
+        void shiftOut() const;
+
+
+public:
+
+    // Constructor (wiring, pins, number of slots), all slots charge
+    Switches(const enum bus, const uint8_t*, const unsigned int);
+
+    // Destructor
+    ~Switches();
+
+
+    // Public Return Functions
+
+        // Return the number of slots
+        inline unsigned int size() const { return n_; }
+
+        // Return true if the output of the slot connects the charger
+        inline bool output(const unsigned int slot) const
+        {
+            return (output_ >> slot) & 1;
+        }
+
+
+    // Public Member Functions
+
+        // Set the pin modes and write the state of all slots
+        void begin();
+
+        // Request the charger (true) or the discharge resistor (false) for
+        // the slot, written with the next apply()
+        void charge(const unsigned int, const bool);
+
+        // Write the requested state of all slots if it changed (once per
+        // loop)
+        void apply();
+
+        // Print the statistics
+        void report(Print&) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,114 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "temperatureBus.h"
+#include "../hal/hal.h"
+
+// * * * * * * * * * * * * * * Static Data Members * * * * * * * * * * * * //
+
+const unsigned int TemperatureBus::nMax;
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+TemperatureBus::TemperatureBus(DallasTemperature& sensors)
+:
+    sensors_(sensors),
+    converting_(false),
+    next_(0),
+    tStart_(0),
+    tConversion_(750)
+{
+    for (unsigned int i = 0; i < nMax; ++i)
+    {
+        address_[i] = nullptr;
+        T_[i] = DEVICE_DISCONNECTED_C;
+        tT_[i] = 0;
+    }
+}
+
+
+TemperatureBus::~TemperatureBus()
+{}
+
+
+// * * * * * * * * * * * * * Public Setter Functions * * * * * * * * * * * * //
+
+void TemperatureBus::attach(const int slot, const byte* address)
+{
+    if (slot >= 0 && slot < int(nMax))
+    {
+        address_[slot] = address;
+    }
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void TemperatureBus::begin()
+{
+    tConversion_ =
+        sensors_.millisToWaitForConversion(sensors_.getResolution());
+
+    // First conversion is blocking
+    sensors_.setWaitForConversion(true);
+    sensors_.requestTemperatures();
+
+    for (unsigned int i = 0; i < nMax; ++i)
+    {
+        collect(i);
+    }
+
+    sensors_.setWaitForConversion(false);
+}
+
+
+void TemperatureBus::tick()
+{
+    if (!converting_)
+    {
+        // One conversion for all sensors on the bus
+        sensors_.requestTemperatures();
+
+        tStart_ = hal().millis();
+        converting_ = true;
+        next_ = 0;
+    }
+    else if (hal().millis() - tStart_ >= tConversion_)
+    {
+        collect(next_);
+
+        // Skip the free slots, a new conversion after the last sensor
+        do
+        {
+            ++next_;
+        } while (next_ < nMax && !address_[next_]);
+
+        converting_ = next_ < nMax;
+    }
+}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+void TemperatureBus::collect(const unsigned int i)
+{
+    if (address_[i])
+    {
+        T_[i] = sensors_.getTempC(address_[i]);
+        tT_[i] = hal().millis();
+    }
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,122 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Asynchronous temperature service for all DS18B20 sensors on the bus.
+    One broadcast conversion is started for all sensors at once and the
+    function returns immediately. If the conversion time passed, the
+    scratchpads of the attached sensors are read one per call (round-robin)
+    and cached together with their time stamp; the next conversion starts
+    after the last one. Hence, the OneWire traffic per call does not depend
+    on the number of slots and the loop is never blocked for the 750 ms of
+    a conversion.
+
+SourceFiles
+    temperatureBus.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef temperatureBus_h
+#define temperatureBus_h
+
+#include <Arduino.h>
+#include <DallasTemperature.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                       Class TemperatureBus Declaration
+\*---------------------------------------------------------------------------*/
+
+class TemperatureBus
+{
+public:
+
+    // Maximum number of sensors (slots) on the bus
+    static const unsigned int nMax = 16;
+
+
+private:
+
+    // Private class data
+
+        // Reference to the sensors object
+        DallasTemperature& sensors_;
+
+        // Addresses of the attached sensors (owned by the battery objects)
+        const byte* address_[nMax];
+
+        // Cached temperatures (dC)
+        float T_[nMax];
+
+        // Time stamp of the cached temperatures (ms)
+        unsigned long tT_[nMax];
+
+        // Is a conversion running or not read completely
+        bool converting_;
+
+        // Next sensor to be read of the finished conversion
+        unsigned int next_;
+
+        // Start of the actual conversion (ms)
+        unsigned long tStart_;
+
+        // Conversion time of the sensors (ms)
+        unsigned long tConversion_;
+
+
+    // Private Member Functions
+
+        // Read the value of the sensor into the cache if it is attached
+        void collect(const unsigned int);
+
+
+public:
+
+    // Constructor
+    TemperatureBus(DallasTemperature&);
+
+    // Destructor
+    ~TemperatureBus();
+
+
+    // Public Setter Functions
+
+        // Attach the sensor address of the given slot
+        void attach(const int, const byte*);
+
+
+    // Public Return Functions
+
+        // Return the cached temperature of the slot (dC)
+        inline float T(const int slot) const { return T_[slot]; }
+
+        // Return the time stamp of the cached temperature (ms)
+        inline unsigned long tT(const int slot) const { return tT_[slot]; }
+
+
+    // Public Member Functions
+
+        // Switch the sensors to non-blocking mode and make a first (blocking)
+        // conversion, hence valid values are available from the start
+        void begin();
+
+        // Start a new conversion or read the next sensor of the finished
+        // one (never blocks)
+        void tick();
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
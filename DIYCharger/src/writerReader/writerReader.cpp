@@ -13,10 +13,15 @@ License
 
 #include <Streaming.h>
 #include "writerReader.h"
+#include "../log/log.h"
+#include "../hal/hal.h"
 
 // * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * ///
 
 WriterReader::WriterReader()
+:
+    buffer_(120000),
+    cellID_(0)
 {}
 
 
@@ -28,138 +33,155 @@ WriterReader::~WriterReader()
 
 void WriterReader::writeData
 (
-    const String fileName,
+    const char* fileName,
     const float t,
     const float U,
     const float I,
     const float P,
     const float C,
     const float e
-) const
+)
 {
-    // Start file system
-    if (startFS())
+    // Create the data record
+    const SampleRecord record = SampleLog::encode(t, U, I, P, C, e);
+
+    // Add it to the buffer, the flash is only written if a page is full or
+    // the oldest record reached the maximum age
+    if (!buffer_.fits(sizeof(record)))
     {
-        if (!fileExist(fileName))
-        {
-            // Create the file
-            if(!createFile(fileName))
-            {
-                Serial
-                    << "ERROR: File '" + fileName + "' could not be created"
-                    << endl;
-            }
-            else
-            {
-                // Create some header information
-                // Note, the empty lines at the beginning are going to be
-                // replaced at the end of the test
-                String header ="";
-
-                // Initialize 10 lines for adding data at the end of the
-                // analysis
-                for (unsigned int i = 0; i < 8; ++i)
-                {
-                    header += "#                                           \n";
-                }
+        flush(fileName);
+    }
 
-                header += "#";
+    buffer_.append(reinterpret_cast<const uint8_t*>(&record), sizeof(record));
 
-                for (unsigned int i = 0; i < 80; ++i)
-                {
-                    header += "=";
-                }
+    if (buffer_.due(sizeof(record)))
+    {
+        flush(fileName);
+    }
+}
 
-                header += "\n";
 
-                header += "# t (s)\tU (V)\tI (mA)\tP (mW)\tC (mAh)\te (mWh)\n#";
+void WriterReader::insertHorizontalLineToFile(const char* fileName)
+{
+    const SampleRecord line = SampleLog::separator();
 
-                for (unsigned int i = 0; i < 80; ++i)
-                {
-                    header += "=";
-                }
+    if (!buffer_.fits(sizeof(line)))
+    {
+        flush(fileName);
+    }
 
-                header += "\n";
+    buffer_.append(reinterpret_cast<const uint8_t*>(&line), sizeof(line));
 
-                // Open the file, and set the id = 1
-                if (!FileSystem::writeData(fileName, header, "w"))
-                {
-                    Serial
-                        << "ERROR: File '" + fileName + " not written"
-                        << endl;
-                }
-            }
-        }
+    // Phase boundary, commit everything
+    flush(fileName);
+}
 
-        // Create data string
-        const String data =
-            String(t, 2) + "\t"
-          + String(U, 4) + "\t"
-          + String(I, 4) + "\t"
-          + String(P, 2) + "\t"
-          + String(C, 2) + "\t"
-          + String(e, 2) + "\t\n";
-          /*
-            String(_FLOAT(t, 2)) + "\t"
-          + String(_FLOAT(U, 4) + "\t"
-          + String(_FLOAT(I, 4) + "\t"
-          + String(_FLOAT(P, 2) + "\t"
-          + String(_FLOAT(C, 2) + "\t"
-          + String(_FLOAT(e, 2) + "\t\n";
-          */
-
-        // Write the data
-        FileSystem::writeData(fileName, data, "a");
 
-        stopFS();
-    }
-    else
+bool WriterReader::flush(const char* fileName)
+{
+    if (buffer_.empty())
     {
-        Serial << "ERROR: Could not start LittleFS File System" << endl;
+        return true;
     }
-}
 
+    bool success = false;
 
-void WriterReader::insertHorizontalLineToFile(const String fileName) const
-{
     // Start file system
     if (startFS())
     {
-        if (fileExist(fileName))
+        if (!fileExist(fileName))
         {
-            String line = "#";
-
-            for (unsigned int i = 0; i < 80; ++i)
+            // Create the file
+            if(!createFile(fileName))
             {
-                line += "-";
+                LOGE
+                (
+                    "ERROR: File '" << fileName << "' could not be created"
+                    << endl
+                );
             }
-
-            line += "\n";
-
-            if (!FileSystem::writeData(fileName, line, "a"))
+            else
             {
-                Serial
-                    << "ERROR: File '" + fileName + " not written"
-                    << endl;
+                // Create the binary header followed by the empty summary
+                // Note, the summary is written in place at the end of the
+                // test
+                uint8_t header[SampleLog::dataOffset];
+
+                const SampleLogHeader h = SampleLog::header();
+                const SampleLogSummary summary = SampleLog::summary();
+                memcpy(header, &h, sizeof(h));
+                memcpy
+                (
+                    header + SampleLog::summaryOffset,
+                    &summary,
+                    sizeof(summary)
+                );
+
+                if
+                (
+                   !FileSystem::writeData
+                    (
+                        fileName,
+                        header,
+                        sizeof(header),
+                        "w"
+                    )
+                )
+                {
+                    LOGE
+                    (
+                        "ERROR: File '" << fileName << "' not written" << endl
+                    );
+                }
             }
         }
+
+        // Write all buffered records at once
+        success =
+            FileSystem::writeData
+            (
+                fileName,
+                buffer_.data(),
+                buffer_.size(),
+                "a"
+            );
+
+        if (!success)
+        {
+            LOGE("ERROR: File '" << fileName << "' not written" << endl);
+        }
+
+        stopFS();
     }
     else
     {
-        Serial << "ERROR: Could not start LittleFS File System" << endl;
+        LOGE("ERROR: Could not start LittleFS File System" << endl);
     }
+
+    buffer_.clear();
+
+    return success;
 }
 
 
-void WriterReader::removeDataFile(const String fileName) const
+bool WriterReader::flushExpired(const char* fileName)
 {
+    return buffer_.expired() ? flush(fileName) : true;
+}
+
+
+void WriterReader::removeDataFile(const char* fileName)
+{
+    // Buffered records belong to the removed file
+    buffer_.clear();
+
     if (startFS())
     {
         if (fileExist(fileName))
         {
             if(!deleteFile(fileName))
             {
-                Serial << "ERROR: Could not delete '" + fileName + "'" << endl;
+                LOGE("ERROR: Could not delete '" << fileName << "'" << endl);
             }
         }
 
@@ -168,67 +190,83 @@ void WriterReader::removeDataFile(const String fileName) const
 }
 
 
-void WriterReader::showDataFileContent(const String fileName) const
+bool WriterReader::showDataFileContent
+(
+    const char* fileName,
+    LogReader& reader
+)
 {
-    if (startFS())
-    {
-        if (fileExist(fileName))
-        {
-            Serial << "Show the content of the file" << endl;
-
-            File f = openFile(fileName);
+    flush(fileName);
 
-            while (f.available())
-            {
-                Serial << f.readString() << "\n";
-            }
+    if (!reader.open(fileName))
+    {
+        LOGW("File '" << fileName << "' not available" << endl);
+        return false;
+    }
 
-            Serial << endl;
-        }
-        else
-        {
-            Serial << "File '" << fileName << "' not available" << endl;
-        }
+    LOGI("Show the content of the file" << endl);
 
-        stopFS();
-    }
+    return true;
 }
 
 
 void WriterReader::addFinalDataToFile
 (
-    const String fileName,
+    const char* fileName,
     const unsigned int nCycles,
     const float U,
     const float CAve,
-    const float eAve
-) const
+    const float eAve,
+    const unsigned long tStart
+)
 {
+    flush(fileName);
+
+    // Get the running cell ID (indicates how many cells were already
+    // analyzed, the function also increments and saves the file)
+    cellID_ = actualCellID();
+
+    if (cellID_ < 0)
+    {
+        LOGE("ERROR: Cell ID < 0, not possible" << endl);
+        cellID_ = 0;
+    }
+
     if (startFS())
     {
         if (fileExist(fileName))
         {
-            // Create the string to be added
-            // First line will be updated in ::updateFileName with the
-            // correct battery id, hence we need to keep it free
-            String info =
-                "#                                                     \n";
-
-            info +=
-                "#----------------------------------------------------------\n";
-
-            info +=
-                "# Voltage after last charging (V): " + String(U) + "\n"
-             +  "# Discharge cycles      : " + String(nCycles) + "\n"
-             +  "# Average energy (mWh)  : " + String(eAve) + "\n"
-             +  "# Average capacity (mAh): " + String(CAve) + "\n"
-             +  "#----------------------------------------------------------\n";
-
-            FileSystem::writeData(fileName, info, "r+");
+            // All results in one fixed-size block, written in place
+            const SampleLogSummary summary =
+                SampleLog::summary
+                (
+                    cellID_,
+                    nCycles,
+                    U,
+                    CAve,
+                    eAve,
+                    tStart,
+                    hal().millis()
+                );
+
+            if
+            (
+               !FileSystem::writeData
+                (
+                    fileName,
+                    reinterpret_cast<const uint8_t*>(&summary),
+                    sizeof(summary),
+                    "r+",
+                    SampleLog::summaryOffset
+                )
+            )
+            {
+                LOGE("ERROR: File '" << fileName << "' not written" << endl);
+            }
         }
         else
         {
-            Serial << "File '" << fileName << "' not available" << endl;
+            LOGW("File '" << fileName << "' not available" << endl);
         }
 
         stopFS();
@@ -236,31 +274,54 @@ void WriterReader::addFinalDataToFile
 }
 
 
-void WriterReader::updateFileName(const String fileName) const
+bool WriterReader::finalized(const char* fileName)
 {
-    // First of all, get the running cell ID (indicates how many cells were
-    // already analyzed (function also increments and safes the file)
-    const int cellID = actualCellID();
-
-    if (cellID < 0)
-    {
-        Serial << "ERROR: Cell ID < 0, not possible" << endl;
-        return;
-    }
+    bool final = false;
 
     if (startFS())
     {
         if (fileExist(fileName))
         {
-            // Add the cell id into the first line
-            const String tmp = "# Battery number: " + String(cellID);
-            FileSystem::writeData(fileName, tmp, "r+");
+            File f = openFile(fileName);
+
+            SampleLogHeader h;
+            SampleLogSummary s;
+
+            final =
+                f.read(reinterpret_cast<uint8_t*>(&h), sizeof(h)) == sizeof(h)
+             && SampleLog::valid(h)
+             && h.version > 1
+             && f.seek(SampleLog::summaryOffset)
+             && f.read(reinterpret_cast<uint8_t*>(&s), sizeof(s)) == sizeof(s)
+             && (s.flags & SampleLog::FINISHED)
+             && s.cellID > 0;
+
+            f.close();
+
+            if (final)
+            {
+                cellID_ = int(s.cellID);
+            }
         }
 
         stopFS();
     }
 
-    //rename(fileName, "battery_" + String(cellID));
+    return final;
+}
+
+
+void WriterReader::updateFileName(const char* fileName) const
+{
+    // The cell ID is assigned and stored in the summary by
+    // ::addFinalDataToFile
+    if (cellID_ <= 0)
+    {
+        LOGE("ERROR: No cell ID assigned to '" << fileName << "'" << endl);
+        return;
+    }
+
+    //rename(fileName, "battery_" + String(cellID_));
 }
 
 
@@ -283,7 +344,7 @@ int WriterReader::actualCellID() const
             // Creat the file
             if(!createFile("cellID"))
             {
-                Serial << "ERROR: File 'cellID' could not be created" << endl;
+                LOGE("ERROR: File 'cellID' could not be created" << endl);
                 result = -1;
             }
             else
@@ -291,7 +352,7 @@ int WriterReader::actualCellID() const
                 // Open the file, and set the id = 1
                 if (!FileSystem::writeData("cellID", "1", "w"))
                 {
-                    Serial << "ERROR: File 'cellID' not written" << endl;
+                    LOGE("ERROR: File 'cellID' not written" << endl);
                     result = -1;
                 }
             }
@@ -299,29 +360,32 @@ int WriterReader::actualCellID() const
 
         // If file already exist, read data, increment the number and
         // save the new integer
-        String data = "";
+        char data[12];
 
-        if (readFirstLine("cellID", data))
+        if (readFirstLine("cellID", data, sizeof(data)))
         {
-            const int cellID = data.toInt() + 1;
+            const int cellID = atoi(data) + 1;
 
             result = cellID;
 
-            if (!FileSystem::writeData("cellID", String(cellID), "w"))
+            Formatter<12> id;
+            id.integer(cellID);
+
+            if (!FileSystem::writeData("cellID", id.c_str(), "w"))
             {
-                Serial <<  "ERROR: File 'cellID' not written" << endl;
+                LOGE("ERROR: File 'cellID' not written" << endl);
                 result = -1;
             }
         }
         else
         {
-            Serial << "ERROR: Could not read file 'cellID'" << endl;
+            LOGE("ERROR: Could not read file 'cellID'" << endl);
             result = -1;
         }
     }
     else
     {
-        Serial << "ERROR: Could not start LittleFS File System" << endl;
+        LOGE("ERROR: Could not start LittleFS File System" << endl);
         result = -1;
     }
 
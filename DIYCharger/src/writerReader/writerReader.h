@@ -13,6 +13,8 @@ Description
     This class is used to write and read the data needed in the battery class
     It takes the FileSystem class as base for the IO operations but manipulates
     the data first for the correct handling, structur and formatation
+    The measurement data are stored in the binary format of SampleLog and
+    converted back to text if the file content is shown
 
 SourceFiles
     writeReader.cpp
@@ -23,6 +25,10 @@ SourceFiles
 #define writerReader_h
 
 #include "../filesystem/filesystem.h"
+#include "../sampleLog/sampleLog.h"
+#include "../logBuffer/logBuffer.h"
+#include "../logReader/logReader.h"
+#include "../format/format.h"
 
 // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
 
@@ -37,6 +43,11 @@ class WriterReader
 {
     // Private class data
 
+        // Write-behind buffer of the measurement records (max. age 120 s)
+        LogBuffer buffer_;
+
+        // Cell ID assigned at the end of the test (0 := not assigned yet)
+        int cellID_;
 
 public:
 
@@ -52,44 +63,62 @@ public:
 
     // Public Return Functions
 
+        // Return the cell ID assigned at the end of the test (0 if none)
+        inline int cellID() const { return cellID_; }
 
 
     // Public Member Functions
 
         // Write the di/charging data to the slot name (the name will be
         // changed at the end of the test to fit the correct battery ID)
+        // The data are buffered and written page-wise
         void writeData
         (
-            const String,
+            const char*,
             const float,
             const float,
             const float,
             const float,
             const float,
             const float
-        ) const;
+        );
+
+        // Write a separator record (shown as 80 character line based on
+        // '-' signs) and commit all buffered records
+        void insertHorizontalLineToFile (const char*);
+
+        // Commit all buffered records to the file
+        bool flush(const char*);
 
-        // Write a 80 character line based on '-' signs
-        void insertHorizontalLineToFile (const String) const;
+        // Commit the buffered records if the oldest reached the maximum
+        // age, otherwise they wait for a full page
+        bool flushExpired(const char*);
 
         // Remove the specified file from the system
-        void removeDataFile(const String) const;
+        void removeDataFile(const char*);
 
-        // Show the content of the data file
-        void showDataFileContent(const String) const;
+        // Open the data file in the reader which shows its content chunk
+        // by chunk (see LogReader::next), return false if not available
+        bool showDataFileContent(const char*, LogReader&);
 
-        // Add final file content such as summaries
+        // Assign the cell ID and write the summary (cycles, final voltage,
+        // averages, start time of the test) in place into the file
         void addFinalDataToFile
         (
-            const String,
+            const char*,
             const unsigned int,
             const float,
             const float,
-            const float
-        ) const;
+            const float,
+            const unsigned long
+        );
+
+        // Return true if the final data are already in the file (e.g.,
+        // written before a reset), the cell ID is taken from its summary
+        bool finalized(const char*);
 
-        // Update the file name to 'battery_<ID>' and update the cellID file
-        void updateFileName(const String) const;
+        // Update the file name to 'battery_<ID>'
+        void updateFileName(const char*) const;
 
 
 private:
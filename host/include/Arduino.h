@@ -0,0 +1,327 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Host replacement of the parts of the ESP8266 Arduino core which are used
+    by the BatteryCharger (String, Print, Stream, Serial and the pin names of
+    the Wemos D1 mini). The clock and IO functions are intentionally missing
+    here, all code has to use the HAL (src/hal/hal.h) instead.
+
+SourceFiles
+    arduinoCore.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef host_Arduino_h
+#define host_Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+using std::abs;
+using std::isinf;
+using std::isnan;
+
+// * * * * * * * * * * * * * * * * Definitions  * * * * * * * * * * * * * * //
+
+typedef uint8_t byte;
+
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x00
+#define OUTPUT 0x01
+
+#define DEC 10
+#define HEX 16
+
+#define constrain(amt, low, high) \
+    ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Pin mapping of the Wemos D1 mini
+static const uint8_t D0 = 16;
+static const uint8_t D1 = 5;
+static const uint8_t D2 = 4;
+static const uint8_t D3 = 0;
+static const uint8_t D4 = 2;
+static const uint8_t D5 = 14;
+static const uint8_t D6 = 12;
+static const uint8_t D7 = 13;
+static const uint8_t D8 = 15;
+static const uint8_t A0 = 17;
+static const uint8_t LED_BUILTIN = 2;
+
+// Cooperative multitasking of the ESP8266 (nothing to do on the host)
+inline void yield() {}
+
+
+/*---------------------------------------------------------------------------*\
+                           Class String Declaration
+\*---------------------------------------------------------------------------*/
+
+class String
+{
+    // Private data
+
+        std::string s_;
+
+public:
+
+    // Constructors
+
+        String(const char* s = "") : s_(s ? s : "") {}
+        String(const std::string& s) : s_(s) {}
+        explicit String(const char c) : s_(1, c) {}
+        explicit String(const int, const unsigned char base = 10);
+        explicit String(const unsigned int, const unsigned char base = 10);
+        explicit String(const long, const unsigned char base = 10);
+        explicit String(const unsigned long, const unsigned char base = 10);
+        explicit String(const float, const unsigned char decimals = 2);
+        explicit String(const double, const unsigned char decimals = 2);
+
+
+    // Public Member Functions
+
+        const char* c_str() const { return s_.c_str(); }
+        unsigned int length() const { return s_.length(); }
+        bool reserve(const unsigned int n) { s_.reserve(n); return true; }
+
+        bool concat(const String& s) { s_ += s.s_; return true; }
+
+        String& operator+=(const String& s) { s_ += s.s_; return *this; }
+        String& operator+=(const char* s) { s_ += s; return *this; }
+        String& operator+=(const char c) { s_ += c; return *this; }
+        String& operator+=(const int n) { return *this += String(n); }
+        String& operator+=(const unsigned int n) { return *this += String(n); }
+        String& operator+=(const long n) { return *this += String(n); }
+        String& operator+=(const unsigned long n)
+        {
+            return *this += String(n);
+        }
+        String& operator+=(const float n) { return *this += String(n); }
+        String& operator+=(const double n) { return *this += String(n); }
+
+        char operator[](const unsigned int i) const { return s_[i]; }
+
+        bool operator==(const String& s) const { return s_ == s.s_; }
+        bool operator!=(const String& s) const { return s_ != s.s_; }
+        bool equals(const String& s) const { return s_ == s.s_; }
+        bool startsWith(const String& s) const
+        {
+            return s_.compare(0, s.s_.size(), s.s_) == 0;
+        }
+
+        int indexOf(const char c, const unsigned int from = 0) const;
+        String substring(const unsigned int, const unsigned int) const;
+        String substring(const unsigned int from) const
+        {
+            return substring(from, length());
+        }
+        void trim();
+
+        long toInt() const { return std::atol(s_.c_str()); }
+        float toFloat() const { return std::atof(s_.c_str()); }
+};
+
+
+// * * * * * * * * * * * * * * * Global Operators  * * * * * * * * * * * * * //
+
+inline String operator+(const String& a, const String& b)
+{
+    String s(a);
+    s += b;
+    return s;
+}
+
+inline String operator+(const String& a, const char* b)
+{
+    String s(a);
+    s += b;
+    return s;
+}
+
+inline String operator+(const char* a, const String& b)
+{
+    String s(a);
+    s += b;
+    return s;
+}
+
+inline String operator+(const String& a, const char b)
+{
+    String s(a);
+    s += b;
+    return s;
+}
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Print Declaration
+\*---------------------------------------------------------------------------*/
+
+class Print
+{
+public:
+
+    virtual ~Print() {}
+
+    virtual size_t write(const uint8_t) = 0;
+    virtual size_t write(const uint8_t*, size_t);
+
+    size_t write(const char* s);
+    size_t write(const char* s, const size_t n)
+    {
+        return write(reinterpret_cast<const uint8_t*>(s), n);
+    }
+
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char*);
+    size_t print(const String&);
+    size_t print(const char);
+    size_t print(const int, const int = DEC);
+    size_t print(const unsigned int, const int = DEC);
+    size_t print(const long, const int = DEC);
+    size_t print(const unsigned long, const int = DEC);
+    size_t print(const double, const int = 2);
+
+    size_t println();
+    template<class T>
+    size_t println(const T& x) { const size_t n = print(x); return n + println(); }
+    template<class T>
+    size_t println(const T& x, const int f)
+    {
+        const size_t n = print(x, f);
+        return n + println();
+    }
+};
+
+
+/*---------------------------------------------------------------------------*\
+                           Class Stream Declaration
+\*---------------------------------------------------------------------------*/
+
+class Stream
+:
+    public Print
+{
+public:
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    size_t readBytes(char*, const size_t);
+    String readString();
+    String readStringUntil(const char);
+};
+
+
+/*---------------------------------------------------------------------------*\
+                       Class HardwareSerial Declaration
+\*---------------------------------------------------------------------------*/
+
+class HardwareSerial
+:
+    public Stream
+{
+public:
+
+    // Size of the UART TX FIFO (bytes)
+    static const int fifoSize = 128;
+
+    // Statistics of the serial output
+    struct Statistics
+    {
+        unsigned long bytes;
+        unsigned long long blockedUs;
+    };
+
+
+private:
+
+    // Private data
+
+        // Output stream of the host (nullptr mutes the serial interface)
+        FILE* out_;
+
+        // Baud rate
+        unsigned long baud_;
+
+        // Virtual time (us) at which the TX FIFO runs empty
+        unsigned long long tEmpty_;
+
+        // Received bytes and position of the next one to be read
+        std::string input_;
+        size_t inputPos_;
+
+        // Input which is received at a later (virtual) time (us)
+        std::vector<std::pair<unsigned long long, std::string>> scheduled_;
+
+        Statistics statistics_;
+
+
+    // Private Member Functions
+
+        // Transmission time of one byte (us), 0 if not started
+        unsigned long long tByte() const
+        {
+            return baud_ ? 10000000ULL/baud_ : 0;
+        }
+
+public:
+
+    HardwareSerial()
+    :
+        out_(stdout),
+        baud_(0),
+        tEmpty_(0),
+        inputPos_(0),
+        statistics_{0, 0}
+    {}
+
+    void begin(const unsigned long baud) { baud_ = baud; }
+    unsigned long baudRate() const { return baud_; }
+    void setOutput(FILE* out) { out_ = out; }
+
+    // Queue bytes as if they were received at the given time (us)
+    void addInput(const std::string&, const unsigned long long = 0);
+
+    // The bytes drain from the FIFO with the baud rate on the virtual
+    // clock; a write into the full FIFO blocks like the UART driver
+    using Print::write;
+    size_t write(const uint8_t);
+    int availableForWrite();
+
+    int available();
+    int read() { return available() ? uint8_t(input_[inputPos_++]) : -1; }
+    int peek() { return available() ? uint8_t(input_[inputPos_]) : -1; }
+
+    operator bool() const { return true; }
+
+    const Statistics& statistics() const { return statistics_; }
+};
+
+extern HardwareSerial Serial;
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,147 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Host replacement of the DallasTemperature library with a fake DS18B20
+    bus. Each sensor is registered with its address and a script that
+    returns the temperature for a given (virtual) time. The conversion time
+    of the DS18B20 is simulated with the HAL clock: a blocking request waits
+    the full conversion time, and until the first conversion is finished a
+    sensor returns its power-on value of 85 dC.
+
+SourceFiles
+    dallasTemperature.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef host_DallasTemperature_h
+#define host_DallasTemperature_h
+
+#include <Arduino.h>
+#include <OneWire.h>
+#include <functional>
+#include <vector>
+
+// * * * * * * * * * * * * * * * * Definitions  * * * * * * * * * * * * * * //
+
+typedef uint8_t DeviceAddress[8];
+
+#define DEVICE_DISCONNECTED_C -127
+
+
+/*---------------------------------------------------------------------------*\
+                         Class DS18B20Bus Declaration
+\*---------------------------------------------------------------------------*/
+
+class DS18B20Bus
+{
+public:
+
+    // Temperature (dC) as function of the time (ms)
+    typedef std::function<float(unsigned long)> Script;
+
+    // Statistics of the bus usage
+    struct Statistics
+    {
+        unsigned long conversions;
+        unsigned long blockedMs;
+    };
+
+    struct Sensor
+    {
+        uint8_t address[8];
+        Script script;
+        unsigned long tStart;
+        bool converting;
+        float value;
+    };
+
+
+private:
+
+    // Private data
+
+        std::vector<Sensor> sensors_;
+
+        Statistics statistics_;
+
+
+public:
+
+    DS18B20Bus();
+
+    // Add a sensor with the given address to the bus
+    void addSensor(const uint8_t*, const Script&);
+
+    Sensor* find(const uint8_t*);
+
+    std::vector<Sensor>& sensors() { return sensors_; }
+
+    const Statistics& statistics() const { return statistics_; }
+    Statistics& statistics() { return statistics_; }
+};
+
+extern DS18B20Bus TBusHost;
+
+
+/*---------------------------------------------------------------------------*\
+                     Class DallasTemperature Declaration
+\*---------------------------------------------------------------------------*/
+
+class DallasTemperature
+{
+    // Private data
+
+        OneWire* wire_;
+
+        bool waitForConversion_;
+
+        uint8_t resolution_;
+
+
+    // Private Member Functions
+
+        // Finalize the conversions which are finished by now
+        void latch(DS18B20Bus::Sensor&) const;
+
+        // Wait for the conversion if we are in blocking mode
+        void blockTillConversionComplete();
+
+
+public:
+
+    explicit DallasTemperature(OneWire*);
+
+    void begin() {}
+
+    uint8_t getDeviceCount() const;
+    bool getAddress(uint8_t*, const uint8_t) const;
+
+    void setResolution(const uint8_t);
+    uint8_t getResolution() const { return resolution_; }
+
+    void setWaitForConversion(const bool w) { waitForConversion_ = w; }
+    bool getWaitForConversion() const { return waitForConversion_; }
+
+    int16_t millisToWaitForConversion(const uint8_t) const;
+    bool isConversionComplete() const;
+
+    void requestTemperatures();
+    bool requestTemperaturesByAddress(const uint8_t*);
+
+    float getTempC(const uint8_t*) const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,165 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Host replacement of the ESP8266 LittleFS. Each file of the flash is a
+    regular file in a directory on the host (default: ./littlefs). Accessing
+    files while the file system is not mounted fails as it does on the board.
+    The mount, open and write operations are counted to analyse the IO load
+    of the charger.
+
+SourceFiles
+    littleFS.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef host_LittleFS_h
+#define host_LittleFS_h
+
+#include <Arduino.h>
+#include <memory>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+
+/*---------------------------------------------------------------------------*\
+                           Class File Declaration
+\*---------------------------------------------------------------------------*/
+
+class File
+:
+    public Stream
+{
+    // Private data
+
+        // Shared handle (copies of a File refer to the same open file)
+        std::shared_ptr<FILE> f_;
+
+        // File name
+        String name_;
+
+public:
+
+    File() {}
+    File(FILE*, const String&);
+
+    operator bool() const { return f_ != nullptr; }
+
+    using Print::write;
+    size_t write(const uint8_t);
+    size_t write(const uint8_t*, size_t);
+
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t*, const size_t);
+
+    bool seek(const uint32_t, const SeekMode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush();
+    void close();
+
+    const char* name() const { return name_.c_str(); }
+};
+
+
+/*---------------------------------------------------------------------------*\
+                           Class FSInfo Declaration
+\*---------------------------------------------------------------------------*/
+
+struct FSInfo
+{
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+
+/*---------------------------------------------------------------------------*\
+                       Class LittleFSHost Declaration
+\*---------------------------------------------------------------------------*/
+
+class LittleFSHost
+{
+public:
+
+    // IO statistics
+    struct Statistics
+    {
+        unsigned long mounts;
+        unsigned long unmounts;
+        unsigned long opens;
+        unsigned long bytesWritten;
+        unsigned long bytesRead;
+    };
+
+
+private:
+
+    // Private data
+
+        // Directory on the host that holds the flash content
+        std::string root_;
+
+        // Is the file system mounted
+        bool mounted_;
+
+        Statistics statistics_;
+
+
+    // Private Member Functions
+
+        std::string path(const char*) const;
+
+
+public:
+
+    LittleFSHost();
+
+    // Set the host directory that represents the flash
+    void setRoot(const std::string&);
+
+    const Statistics& statistics() const { return statistics_; }
+    Statistics& statistics() { return statistics_; }
+
+    bool begin();
+    void end();
+    bool info(FSInfo&) const;
+
+    bool exists(const char*) const;
+    bool exists(const String& n) const { return exists(n.c_str()); }
+
+    File open(const char*, const char*);
+    File open(const String& n, const char* m) { return open(n.c_str(), m); }
+
+    bool remove(const char*);
+    bool remove(const String& n) { return remove(n.c_str()); }
+
+    bool rename(const char*, const char*);
+    bool rename(const String& a, const String& b)
+    {
+        return rename(a.c_str(), b.c_str());
+    }
+};
+
+extern LittleFSHost LittleFS;
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,42 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Host replacement of the OneWire library. The bus itself is simulated in
+    DallasTemperature.h, hence only the pin is stored.
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef host_OneWire_h
+#define host_OneWire_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+class OneWire
+{
+    // Private data
+
+        uint8_t pin_;
+
+public:
+
+    explicit OneWire(const uint8_t pin) : pin_(pin) {}
+
+    uint8_t pin() const { return pin_; }
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
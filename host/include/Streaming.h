@@ -0,0 +1,43 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Host replacement of the Streaming library (operator<< for Print objects)
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef host_Streaming_h
+#define host_Streaming_h
+
+#include <Arduino.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+enum _EndLineCode { endl };
+
+template<class T>
+inline Print& operator<<(Print& obj, const T& arg)
+{
+    obj.print(arg);
+    return obj;
+}
+
+inline Print& operator<<(Print& obj, const _EndLineCode)
+{
+    obj.println();
+    return obj;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,464 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Host (Linux) driver of the BatteryCharger sketch. The sketch is compiled
+    unchanged against the host backend of the HAL and runs on a virtual
+    clock. Each slot holds a simulated cell (see cellModel.h) which feeds
+    the scripted ADC and the fake DS18B20 bus. At the end, the wall time,
+    the virtual time and the IO statistics are reported.
+
+Usage
+    DIYChargerHost [options]
+        -hours <h>      Virtual run time (default 6)
+        -fs <dir>       Directory representing the flash (default littlefs)
+        -format         Remove all files of the flash before starting
+        -noise <n>      ADC noise amplitude in counts (default 1)
+        -soc <s>        Initial state of charge of the cells (default 0.3)
+        -capacity <Ah>  Capacity of the cells (default 2.5)
+        -ri <Ohm>       Internal resistance of the cells (default 0.08)
+        -ambient <dC>   Ambient temperature of the cells (default 21)
+        -quiet          Do not print the serial output
+        -cells <file>   Load the state of charge of the cells from the file
+                        (if it exists) and save it at the end, i.e., a
+                        second run continues with the same cells
+        -crash          End like a brownout, without committing the
+                        buffered measurement data
+        -query <C0> <C1> List the cells of the catalog with an average
+                        capacity in [C0, C1] mAh
+        -command <line> Send the command line to the serial interface
+                        (repeatable, e.g., -command "cal 0 3700")
+        -at <s>         Virtual time of the following commands
+
+\*---------------------------------------------------------------------------*/
+
+#include "DIYCharger.ino"
+#include "halHost.h"
+#include "cellModel.h"
+#include "heap.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+namespace
+{
+    // Print interface for the reports on stderr
+    class StdErr
+    :
+        public Print
+    {
+    public:
+
+        using Print::write;
+
+        size_t write(const uint8_t c)
+        {
+            return fputc(c, stderr) == EOF ? 0 : 1;
+        }
+    };
+
+
+    // Deterministic noise in [-n, n] counts
+    int noise(const int n)
+    {
+        static unsigned long state = 12345;
+
+        if (n <= 0)
+        {
+            return 0;
+        }
+
+        state = state*1103515245UL + 12345UL;
+
+        return int((state >> 16) % (2*n + 1)) - n;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    double hours = 6;
+    std::string fsRoot = "littlefs";
+    bool format = false;
+    bool quiet = false;
+    bool crash = false;
+    std::string cellsFile;
+    float queryCMin = -1;
+    float queryCMax = -1;
+    int noiseCounts = 1;
+    float soc = 0.3;
+    float capacity = 2.5;
+    float Ri = 0.08;
+    float TAmbient = 21;
+    double tCommand = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = (i + 1 < argc);
+
+        if (!strcmp(argv[i], "-hours") && hasValue)
+        {
+            hours = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-fs") && hasValue)
+        {
+            fsRoot = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-noise") && hasValue)
+        {
+            noiseCounts = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-soc") && hasValue)
+        {
+            soc = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-capacity") && hasValue)
+        {
+            capacity = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-ri") && hasValue)
+        {
+            Ri = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-ambient") && hasValue)
+        {
+            TAmbient = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-format"))
+        {
+            format = true;
+        }
+        else if (!strcmp(argv[i], "-quiet"))
+        {
+            quiet = true;
+        }
+        else if (!strcmp(argv[i], "-cells") && hasValue)
+        {
+            cellsFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-query") && i + 2 < argc)
+        {
+            queryCMin = atof(argv[++i]);
+            queryCMax = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-command") && hasValue)
+        {
+            Serial.addInput
+            (
+                std::string(argv[++i]) + "\n",
+                (unsigned long long)(tCommand*1e6)
+            );
+        }
+        else if (!strcmp(argv[i], "-at") && hasValue)
+        {
+            tCommand = atof(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-crash"))
+        {
+            crash = true;
+        }
+        else
+        {
+            fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // Flash
+    if (format)
+    {
+        std::filesystem::remove_all(fsRoot);
+    }
+
+    LittleFS.setRoot(fsRoot);
+
+    if (quiet)
+    {
+        Serial.setOutput(nullptr);
+    }
+
+    // One simulated cell per slot
+    std::vector<CellModel> cells(slots, CellModel(capacity, Ri, 3.3, soc));
+
+    if (!cellsFile.empty())
+    {
+        if (FILE* f = fopen(cellsFile.c_str(), "r"))
+        {
+            for (auto& cell : cells)
+            {
+                float s = soc;
+
+                if (fscanf(f, "%f", &s) == 1)
+                {
+                    cell = CellModel(capacity, Ri, 3.3, s);
+                }
+            }
+
+            fclose(f);
+        }
+    }
+
+    // Ground truth of the end-of-charge detection: a charge phase that
+    // ends before the charger terminated is a false positive (the short
+    // discharge pulse of the fast screening is not a charge phase)
+    std::vector<bool> charging(slots, false);
+    std::vector<unsigned long long> tCharge(slots, 0);
+    unsigned long eocDetections = 0;
+    unsigned long eocFalse = 0;
+    double eocLatency = 0;
+    double eocLatencyMax = 0;
+
+    HALHost& board = halHost();
+    board.setEndTime((unsigned long long)(hours*3600e3));
+
+    board.setADCScript
+    (
+        0,
+        [&](unsigned long)
+        {
+            // Channel selected at the multiplexer
+            int channel = 0;
+
+            for (int i = 0; slots > 1 && i < 4; ++i)
+            {
+                channel |= (board.digitalRead(muxPins[i]) == HIGH) << i;
+            }
+
+            if (channel >= slots)
+            {
+                return 0;
+            }
+
+            CellModel& cell = cells[channel];
+            const bool charge = switches.output(channel);
+
+            if (charge && !charging[channel])
+            {
+                tCharge[channel] = board.time();
+            }
+
+            if
+            (
+                charging[channel]
+             && !charge
+             && board.time() - tCharge[channel] > 60000
+            )
+            {
+                ++eocDetections;
+
+                if (!cell.terminated())
+                {
+                    ++eocFalse;
+                }
+                else
+                {
+                    const double latency =
+                        (board.time() - cell.tTerminated())/1000.;
+
+                    eocLatency += latency;
+                    eocLatencyMax = fmax(eocLatencyMax, latency);
+                }
+            }
+
+            charging[channel] = charge;
+
+            cell.update(board.time(), charge);
+
+            const int n = cell.counts() + noise(noiseCounts);
+
+            return constrain(n, 0, 1023);
+        }
+    );
+
+    for (int slot = 0; slot < slots; ++slot)
+    {
+        TBusHost.addSensor
+        (
+            TSensorAddresses[slot],
+            [&cells, slot, TAmbient](unsigned long)
+            {
+                return cells[slot].T(TAmbient);
+            }
+        );
+    }
+
+    // Run the sketch
+    const auto wallStart = std::chrono::steady_clock::now();
+    unsigned long nLoops = 0;
+    unsigned long allocationsSetup = 0;
+
+    try
+    {
+        setup();
+
+        allocationsSetup = heap::statistics().allocations;
+
+        while (true)
+        {
+            loop();
+            ++nLoops;
+        }
+    }
+    catch (const HALHost::SimulationEnd&)
+    {}
+
+    // Shutdown, send the pending log messages and commit the buffered
+    // measurement data
+    if (!crash)
+    {
+        logger.flush();
+    }
+
+    for (int slot = 0; !crash && slot < slots; ++slot)
+    {
+        if (batteries[slot])
+        {
+            batteries[slot]->flush();
+        }
+    }
+
+    if (!cellsFile.empty())
+    {
+        if (FILE* f = fopen(cellsFile.c_str(), "w"))
+        {
+            for (const auto& cell : cells)
+            {
+                fprintf(f, "%.6f\n", cell.soc());
+            }
+
+            fclose(f);
+        }
+    }
+
+    const double wall =
+        std::chrono::duration<double>
+        (
+            std::chrono::steady_clock::now() - wallStart
+        ).count();
+
+    const double tVirtual = board.time()/1000.;
+
+    // Report
+    const auto& hs = board.statistics();
+    const auto& fs = LittleFS.statistics();
+    const auto& ts = TBusHost.statistics();
+
+    fprintf(stderr, "\n");
+    fprintf(stderr, "Virtual time (s)      : %.1f\n", tVirtual);
+    fprintf(stderr, "Wall time (s)         : %.3f\n", wall);
+    fprintf(stderr, "Speed-up              : %.0f\n", tVirtual/fmax(wall, 1e-9));
+    fprintf(stderr, "loop() calls          : %lu\n", nLoops);
+    fprintf(stderr, "ADC reads             : %lu\n", hs.analogReads);
+    fprintf(stderr, "Digital writes        : %lu\n", hs.digitalWrites);
+    fprintf
+    (
+        stderr,
+        "delay() calls / ms    : %lu / %llu\n",
+        hs.delays,
+        hs.delayedMs
+    );
+    fprintf
+    (
+        stderr,
+        "Serial bytes / blocked: %lu / %.1f ms (%lu log lines dropped)\n",
+        Serial.statistics().bytes,
+        Serial.statistics().blockedUs/1000.,
+        logger.dropped()
+    );
+    fprintf
+    (
+        stderr,
+        "DS18B20 conversions   : %lu (blocked %lu ms)\n",
+        ts.conversions,
+        ts.blockedMs
+    );
+    fprintf
+    (
+        stderr,
+        "LittleFS mounts/opens : %lu / %lu\n",
+        fs.mounts,
+        fs.opens
+    );
+    fprintf
+    (
+        stderr,
+        "LittleFS bytes w/r    : %lu / %lu\n",
+        fs.bytesWritten,
+        fs.bytesRead
+    );
+
+    fprintf
+    (
+        stderr,
+        "Heap allocations      : %lu (after setup %lu)\n",
+        heap::statistics().allocations,
+        heap::statistics().allocations - allocationsSetup
+    );
+    fprintf
+    (
+        stderr,
+        "Heap free / peak used : %lu / %lu B\n",
+        (unsigned long)heap::free(),
+        (unsigned long)heap::statistics().peak
+    );
+
+    fprintf
+    (
+        stderr,
+        "End of charge         : %lu detected, %lu false, "
+        "latency ave/max %.0f/%.0f s\n",
+        eocDetections,
+        eocFalse,
+        eocDetections > eocFalse ? eocLatency/(eocDetections - eocFalse) : 0,
+        eocLatencyMax
+    );
+
+    fprintf(stderr, "\nScheduler\n");
+    StdErr err;
+    scheduler.report(err);
+    acquisition.report(err);
+    FileSystem::report(err);
+
+    for (int slot = 0; slot < slots; ++slot)
+    {
+        fprintf
+        (
+            stderr,
+            "Cell %d                : U = %.3f V, SOC = %.2f\n",
+            slot,
+            cells[slot].U(),
+            cells[slot].soc()
+        );
+    }
+
+    if (queryCMin >= 0)
+    {
+        fprintf
+        (
+            stderr,
+            "\nCatalog (%lu cells), C = %.0f..%.0f mAh\n",
+            catalog.size(),
+            queryCMin,
+            queryCMax
+        );
+
+        catalog.query(err, queryCMin, queryCMax);
+    }
+
+    return 0;
+}
+
+
+// ************************************************************************* //
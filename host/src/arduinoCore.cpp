@@ -0,0 +1,346 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <Arduino.h>
+#include "halHost.h"
+
+// * * * * * * * * * * * * * * * Global Objects  * * * * * * * * * * * * * * //
+
+HardwareSerial Serial;
+
+
+// * * * * * * * * * * * * * * Local Functions * * * * * * * * * * * * * * * //
+
+namespace
+{
+    std::string integerToString
+    (
+        const unsigned long n,
+        const bool negative,
+        const unsigned char base
+    )
+    {
+        char buf[40];
+
+        if (base == 16)
+        {
+            snprintf(buf, sizeof(buf), "%s%lX", negative ? "-" : "", n);
+        }
+        else
+        {
+            snprintf(buf, sizeof(buf), "%s%lu", negative ? "-" : "", n);
+        }
+
+        return buf;
+    }
+
+
+    std::string floatToString(const double x, const unsigned char decimals)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", int(decimals), x);
+
+        return buf;
+    }
+}
+
+
+// * * * * * * * * * * * * * * String Constructors * * * * * * * * * * * * * //
+
+String::String(const int n, const unsigned char base)
+:
+    s_(integerToString(n < 0 ? -long(n) : n, n < 0, base))
+{}
+
+
+String::String(const unsigned int n, const unsigned char base)
+:
+    s_(integerToString(n, false, base))
+{}
+
+
+String::String(const long n, const unsigned char base)
+:
+    s_(integerToString(n < 0 ? -n : n, n < 0, base))
+{}
+
+
+String::String(const unsigned long n, const unsigned char base)
+:
+    s_(integerToString(n, false, base))
+{}
+
+
+String::String(const float x, const unsigned char decimals)
+:
+    s_(floatToString(x, decimals))
+{}
+
+
+String::String(const double x, const unsigned char decimals)
+:
+    s_(floatToString(x, decimals))
+{}
+
+
+// * * * * * * * * * * * * String Member Functions * * * * * * * * * * * * * //
+
+int String::indexOf(const char c, const unsigned int from) const
+{
+    const size_t i = s_.find(c, from);
+
+    return i == std::string::npos ? -1 : int(i);
+}
+
+
+String String::substring(const unsigned int from, const unsigned int to) const
+{
+    if (from >= s_.size() || to <= from)
+    {
+        return String();
+    }
+
+    return String(s_.substr(from, to - from));
+}
+
+
+void String::trim()
+{
+    const size_t first = s_.find_first_not_of(" \t\r\n");
+
+    if (first == std::string::npos)
+    {
+        s_.clear();
+        return;
+    }
+
+    const size_t last = s_.find_last_not_of(" \t\r\n");
+    s_ = s_.substr(first, last - first + 1);
+}
+
+
+// * * * * * * * * * * * * * Print Member Functions  * * * * * * * * * * * * //
+
+size_t Print::write(const uint8_t* buf, size_t n)
+{
+    size_t written = 0;
+
+    while (n--)
+    {
+        written += write(*buf++);
+    }
+
+    return written;
+}
+
+
+size_t Print::write(const char* s)
+{
+    return write(s, strlen(s));
+}
+
+
+size_t Print::print(const char* s)
+{
+    return write(s);
+}
+
+
+size_t Print::print(const String& s)
+{
+    return write(s.c_str(), s.length());
+}
+
+
+size_t Print::print(const char c)
+{
+    return write(uint8_t(c));
+}
+
+
+size_t Print::print(const int n, const int base)
+{
+    return print(String(n, base));
+}
+
+
+size_t Print::print(const unsigned int n, const int base)
+{
+    return print(String(n, base));
+}
+
+
+size_t Print::print(const long n, const int base)
+{
+    return print(String(n, base));
+}
+
+
+size_t Print::print(const unsigned long n, const int base)
+{
+    return print(String(n, base));
+}
+
+
+size_t Print::print(const double x, const int decimals)
+{
+    return print(String(x, decimals));
+}
+
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+
+// * * * * * * * * * * * * * Stream Member Functions * * * * * * * * * * * * //
+
+size_t Stream::readBytes(char* buf, const size_t n)
+{
+    size_t i = 0;
+
+    while (i < n)
+    {
+        const int c = read();
+
+        if (c < 0)
+        {
+            break;
+        }
+
+        buf[i++] = char(c);
+    }
+
+    return i;
+}
+
+
+String Stream::readString()
+{
+    std::string s;
+
+    int c = read();
+
+    while (c >= 0)
+    {
+        s += char(c);
+        c = read();
+    }
+
+    return String(s);
+}
+
+
+String Stream::readStringUntil(const char terminator)
+{
+    std::string s;
+
+    int c = read();
+
+    while (c >= 0 && c != terminator)
+    {
+        s += char(c);
+        c = read();
+    }
+
+    return String(s);
+}
+
+
+// * * * * * * * * * * * HardwareSerial Member Functions * * * * * * * * * * //
+
+size_t HardwareSerial::write(const uint8_t c)
+{
+    if (out_)
+    {
+        fputc(c, out_);
+    }
+
+    ++statistics_.bytes;
+
+    const unsigned long long dt = tByte();
+
+    if (dt)
+    {
+        HALHost& board = halHost();
+
+        if (tEmpty_ < board.timeUs())
+        {
+            tEmpty_ = board.timeUs();
+        }
+
+        // Wait for a free byte in the FIFO
+        const unsigned long long tFree = tEmpty_ - (fifoSize - 1)*dt;
+
+        if (tEmpty_ >= (fifoSize - 1)*dt && tFree > board.timeUs())
+        {
+            statistics_.blockedUs += tFree - board.timeUs();
+            board.advance(tFree - board.timeUs());
+        }
+
+        tEmpty_ += dt;
+    }
+
+    return 1;
+}
+
+
+void HardwareSerial::addInput
+(
+    const std::string& s,
+    const unsigned long long t
+)
+{
+    auto i = scheduled_.begin();
+
+    while (i != scheduled_.end() && i->first <= t)
+    {
+        ++i;
+    }
+
+    scheduled_.insert(i, std::make_pair(t, s));
+}
+
+
+int HardwareSerial::available()
+{
+    const unsigned long long t = halHost().timeUs();
+
+    while (!scheduled_.empty() && scheduled_.front().first <= t)
+    {
+        input_ += scheduled_.front().second;
+        scheduled_.erase(scheduled_.begin());
+    }
+
+    return int(input_.size() - inputPos_);
+}
+
+
+int HardwareSerial::availableForWrite()
+{
+    const unsigned long long dt = tByte();
+    const unsigned long long t = halHost().timeUs();
+
+    if (!dt || tEmpty_ <= t)
+    {
+        return fifoSize;
+    }
+
+    const int pending = int((tEmpty_ - t + dt - 1)/dt);
+
+    return pending < fifoSize ? fifoSize - pending : 0;
+}
+
+
+// ************************************************************************* //
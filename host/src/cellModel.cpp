@@ -0,0 +1,125 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "cellModel.h"
+#include <cmath>
+
+// * * * * * * * * * * * * * * * Local Data  * * * * * * * * * * * * * * * * //
+
+namespace
+{
+    // Open circuit voltage (V) over state of charge (-)
+    const float socTable[] = {0.0, 0.05, 0.1, 0.2, 0.5, 0.8, 0.95, 1.0};
+    const float ocvTable[] = {2.5, 3.3, 3.5, 3.6, 3.75, 3.95, 4.1, 4.2};
+    const int nTable = sizeof(socTable)/sizeof(float);
+}
+
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+CellModel::CellModel
+(
+    const float capacity,
+    const float Ri,
+    const float RLoad,
+    const float soc
+)
+:
+    capacity_(capacity),
+    Ri_(Ri),
+    RLoad_(RLoad),
+    ICharge_(1.0),
+    UCharge_(4.2),
+    soc_(soc),
+    U_(OCV()),
+    I_(0),
+    terminated_(false),
+    tTerminated_(0),
+    t_(0)
+{}
+
+
+// * * * * * * * * * * * * Private Member Functions  * * * * * * * * * * * * //
+
+float CellModel::OCV() const
+{
+    if (soc_ <= socTable[0])
+    {
+        return ocvTable[0];
+    }
+
+    for (int i = 1; i < nTable; ++i)
+    {
+        if (soc_ <= socTable[i])
+        {
+            const float w =
+                (soc_ - socTable[i-1])/(socTable[i] - socTable[i-1]);
+
+            return ocvTable[i-1] + w*(ocvTable[i] - ocvTable[i-1]);
+        }
+    }
+
+    return ocvTable[nTable-1];
+}
+
+
+// * * * * * * * * * * * * Public Member Functions * * * * * * * * * * * * * //
+
+void CellModel::update(const unsigned long long t, const bool charging)
+{
+    const float dt = (t - t_)/3600e3;
+    t_ = t;
+
+    const float OCV = this->OCV();
+
+    if (charging)
+    {
+        // Constant current until the end-of-charge voltage, then constant
+        // voltage until the current drops below C/10
+        I_ = terminated_ ? 0 : fmin(ICharge_, (UCharge_ - OCV)/Ri_);
+
+        if (!terminated_ && I_ < 0.1*capacity_)
+        {
+            terminated_ = true;
+            tTerminated_ = t;
+            I_ = 0;
+        }
+    }
+    else
+    {
+        terminated_ = false;
+        I_ = -OCV/(RLoad_ + Ri_);
+    }
+
+    soc_ = fmax(0, fmin(1, soc_ + I_*dt/capacity_));
+
+    U_ = OCV + I_*Ri_;
+}
+
+
+float CellModel::T(const float TAmbient) const
+{
+    // Steady state heating by the internal and (nearby) load resistance
+    return TAmbient + 3*fabs(I_);
+}
+
+
+int CellModel::counts() const
+{
+    const int n = int(lround(U_*794/3.2835));
+
+    return n < 0 ? 0 : (n > 1023 ? 1023 : n);
+}
+
+
+// ************************************************************************* //
@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Simple electrical and thermal model of a 18650 cell in a charger slot.
+    It is used by the host backend to script the ADC and the DS18B20 values.
+    The open circuit voltage is interpolated from the state of charge, the
+    cell has an internal resistance and is either connected to a CC/CV
+    charger (TP4056-like, terminating at C/10) or to the discharge
+    resistance.
+
+SourceFiles
+    cellModel.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef cellModel_h
+#define cellModel_h
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class CellModel Declaration
+\*---------------------------------------------------------------------------*/
+
+class CellModel
+{
+    // Private data
+
+        // Capacity (Ah)
+        float capacity_;
+
+        // Internal resistance (Ohm)
+        float Ri_;
+
+        // Discharge resistance (Ohm)
+        float RLoad_;
+
+        // Charge current (A) and end-of-charge voltage (V)
+        float ICharge_;
+        float UCharge_;
+
+        // State of charge (-)
+        float soc_;
+
+        // Terminal voltage (V)
+        float U_;
+
+        // Cell current (A), positive for charging
+        float I_;
+
+        // Charger terminated (current below C/10)
+        bool terminated_;
+
+        // Time of the termination (ms)
+        unsigned long long tTerminated_;
+
+        // Time of the last update (ms)
+        unsigned long long t_;
+
+
+    // Private Member Functions
+
+        // Open circuit voltage for the state of charge
+        float OCV() const;
+
+
+public:
+
+    // Constructor
+    CellModel
+    (
+        const float capacity,
+        const float Ri,
+        const float RLoad,
+        const float soc
+    );
+
+
+    // Public Member Functions
+
+        // Integrate the cell up to the given time (ms)
+        void update(const unsigned long long, const bool charging);
+
+        // Terminal voltage (V)
+        float U() const { return U_; }
+
+        // Current (A)
+        float I() const { return I_; }
+
+        // State of charge (-)
+        float soc() const { return soc_; }
+
+        // Charger terminated (the true end of charge)
+        bool terminated() const { return terminated_; }
+
+        // Time of the termination (ms)
+        unsigned long long tTerminated() const { return tTerminated_; }
+
+        // Cell temperature (dC) for the given ambient temperature
+        float T(const float) const;
+
+        // Raw ADC counts seen at A0 (calibration 794 = 3.2835 V)
+        int counts() const;
+};
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,203 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <DallasTemperature.h>
+#include "hal/hal.h"
+
+// * * * * * * * * * * * * * * * Global Objects  * * * * * * * * * * * * * * //
+
+DS18B20Bus TBusHost;
+
+
+// * * * * * * * * * * * * * * * DS18B20Bus Members * * * * * * * * * * * * //
+
+DS18B20Bus::DS18B20Bus()
+:
+    statistics_{0, 0}
+{}
+
+
+void DS18B20Bus::addSensor(const uint8_t* address, const Script& script)
+{
+    Sensor s;
+
+    memcpy(s.address, address, 8);
+    s.script = script;
+    s.tStart = 0;
+    s.converting = false;
+
+    // Power-on value of the scratchpad
+    s.value = 85;
+
+    sensors_.push_back(s);
+}
+
+
+DS18B20Bus::Sensor* DS18B20Bus::find(const uint8_t* address)
+{
+    for (auto& s : sensors_)
+    {
+        if (memcmp(s.address, address, 8) == 0)
+        {
+            return &s;
+        }
+    }
+
+    return nullptr;
+}
+
+
+// * * * * * * * * * * * * * DallasTemperature Members * * * * * * * * * * * //
+
+DallasTemperature::DallasTemperature(OneWire* wire)
+:
+    wire_(wire),
+    waitForConversion_(true),
+    resolution_(12)
+{}
+
+
+void DallasTemperature::latch(DS18B20Bus::Sensor& s) const
+{
+    const unsigned long tConv = millisToWaitForConversion(resolution_);
+
+    if (s.converting && hal().millis() - s.tStart >= tConv)
+    {
+        s.value = s.script(s.tStart + tConv);
+        s.converting = false;
+    }
+}
+
+
+void DallasTemperature::blockTillConversionComplete()
+{
+    if (waitForConversion_)
+    {
+        const unsigned long tConv = millisToWaitForConversion(resolution_);
+
+        hal().delay(tConv);
+        TBusHost.statistics().blockedMs += tConv;
+    }
+}
+
+
+uint8_t DallasTemperature::getDeviceCount() const
+{
+    return uint8_t(TBusHost.sensors().size());
+}
+
+
+bool DallasTemperature::getAddress(uint8_t* address, const uint8_t i) const
+{
+    if (i >= TBusHost.sensors().size())
+    {
+        return false;
+    }
+
+    memcpy(address, TBusHost.sensors()[i].address, 8);
+
+    return true;
+}
+
+
+void DallasTemperature::setResolution(const uint8_t resolution)
+{
+    resolution_ = constrain(resolution, uint8_t(9), uint8_t(12));
+}
+
+
+int16_t DallasTemperature::millisToWaitForConversion
+(
+    const uint8_t resolution
+) const
+{
+    switch (resolution)
+    {
+        case 9:
+            return 94;
+        case 10:
+            return 188;
+        case 11:
+            return 375;
+        default:
+            return 750;
+    }
+}
+
+
+bool DallasTemperature::isConversionComplete() const
+{
+    const unsigned long tConv = millisToWaitForConversion(resolution_);
+
+    for (const auto& s : TBusHost.sensors())
+    {
+        if (s.converting && hal().millis() - s.tStart < tConv)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+void DallasTemperature::requestTemperatures()
+{
+    for (auto& s : TBusHost.sensors())
+    {
+        s.tStart = hal().millis();
+        s.converting = true;
+    }
+
+    ++TBusHost.statistics().conversions;
+
+    blockTillConversionComplete();
+}
+
+
+bool DallasTemperature::requestTemperaturesByAddress(const uint8_t* address)
+{
+    DS18B20Bus::Sensor* s = TBusHost.find(address);
+
+    if (!s)
+    {
+        return false;
+    }
+
+    s->tStart = hal().millis();
+    s->converting = true;
+
+    ++TBusHost.statistics().conversions;
+
+    blockTillConversionComplete();
+
+    return true;
+}
+
+
+float DallasTemperature::getTempC(const uint8_t* address) const
+{
+    DS18B20Bus::Sensor* s = TBusHost.find(address);
+
+    if (!s)
+    {
+        return DEVICE_DISCONNECTED_C;
+    }
+
+    latch(*s);
+
+    return s->value;
+}
+
+
+// ************************************************************************* //
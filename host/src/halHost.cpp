@@ -0,0 +1,163 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "halHost.h"
+#include "heap.h"
+
+// * * * * * * * * * * * * * * * * Constructors  * * * * * * * * * * * * * * //
+
+HALHost::HALHost()
+:
+    t_(0),
+    tEnd_(~0ULL),
+    tADC_(100),
+    statistics_{0, 0, 0, 0}
+{}
+
+
+HALHost::~HALHost()
+{}
+
+
+// * * * * * * * * * * * * * Public Setter Functions * * * * * * * * * * * * //
+
+void HALHost::setEndTime(const unsigned long long tEnd)
+{
+    tEnd_ = tEnd*1000;
+}
+
+
+void HALHost::setADCScript(const uint8_t pin, const ADCScript& script)
+{
+    adc_[pin] = script;
+}
+
+
+void HALHost::setADCConversionTime(const unsigned long tADC)
+{
+    tADC_ = tADC;
+}
+
+
+void HALHost::advance(const unsigned long long dt)
+{
+    t_ += dt;
+}
+
+
+// * * * * * * * * * * * * Public Clock Functions  * * * * * * * * * * * * * //
+
+unsigned long HALHost::millis() const
+{
+    return (unsigned long)(t_/1000);
+}
+
+
+unsigned long HALHost::micros() const
+{
+    return (unsigned long)t_;
+}
+
+
+void HALHost::delay(const unsigned long ms)
+{
+    if (t_ >= tEnd_)
+    {
+        throw SimulationEnd();
+    }
+
+    ++statistics_.delays;
+    statistics_.delayedMs += ms;
+
+    t_ += 1000ULL*ms;
+}
+
+
+void HALHost::delayMicroseconds(const unsigned int us)
+{
+    t_ += us;
+}
+
+
+// * * * * * * * * * * * * * Public IO Functions * * * * * * * * * * * * * * //
+
+void HALHost::pinMode(const uint8_t, const uint8_t)
+{}
+
+
+void HALHost::digitalWrite(const uint8_t pin, const uint8_t value)
+{
+    ++statistics_.digitalWrites;
+
+    pins_[pin] = value;
+}
+
+
+int HALHost::digitalRead(const uint8_t pin) const
+{
+    const auto iter = pins_.find(pin);
+
+    return iter == pins_.end() ? 0 : iter->second;
+}
+
+
+int HALHost::analogRead(const uint8_t pin)
+{
+    ++statistics_.analogReads;
+
+    t_ += tADC_;
+
+    // A0 can be addressed as pin 17 or as ADC channel 0
+    const auto iter = adc_.find(pin == 17 ? 0 : pin);
+
+    if (iter == adc_.end())
+    {
+        return 0;
+    }
+
+    return iter->second(millis());
+}
+
+
+// * * * * * * * * * * * * Public System Functions * * * * * * * * * * * * //
+
+uint32_t HALHost::freeHeap() const
+{
+    return uint32_t(heap::free());
+}
+
+
+uint32_t HALHost::maxFreeBlock() const
+{
+    // Fragmentation is not modelled
+    return uint32_t(heap::free());
+}
+
+
+// * * * * * * * * * * * * * * * Global Functions  * * * * * * * * * * * * * //
+
+HALHost& halHost()
+{
+    static HALHost board;
+
+    return board;
+}
+
+
+HAL& hal()
+{
+    return halHost();
+}
+
+
+// ************************************************************************* //
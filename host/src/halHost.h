@@ -0,0 +1,163 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Linux backend of the hardware abstraction layer. The clock is virtual,
+    it only advances if the charger waits (delay) or if a peripheral needs
+    time (ADC conversion). Hence, the charger runs much faster than real
+    time on the desktop while all timings seen by the code stay consistent.
+
+    The ADC is scripted: a function per analog pin returns the raw counts
+    for the actual virtual time. The digital outputs are stored and can be
+    read back by the scripts (e.g., to know if a cell is charged or
+    discharged).
+
+    If the end time of the simulation is reached, the next delay() throws
+    HALHost::SimulationEnd which is caught by the host main function.
+
+SourceFiles
+    halHost.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef halHost_h
+#define halHost_h
+
+#include "hal/hal.h"
+#include <functional>
+#include <map>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+
+/*---------------------------------------------------------------------------*\
+                           Class HALHost Declaration
+\*---------------------------------------------------------------------------*/
+
+class HALHost
+:
+    public HAL
+{
+public:
+
+    // Raw ADC counts as function of the time (ms)
+    typedef std::function<int(unsigned long)> ADCScript;
+
+    // Thrown if the virtual end time is reached
+    struct SimulationEnd {};
+
+    // Statistics of the backend usage
+    struct Statistics
+    {
+        unsigned long analogReads;
+        unsigned long digitalWrites;
+        unsigned long delays;
+        unsigned long long delayedMs;
+    };
+
+
+private:
+
+    // Private data
+
+        // Virtual time (us)
+        unsigned long long t_;
+
+        // End of the simulation (us)
+        unsigned long long tEnd_;
+
+        // Duration of one ADC conversion (us)
+        unsigned long tADC_;
+
+        // Digital pin states
+        std::map<uint8_t, uint8_t> pins_;
+
+        // ADC scripts per analog pin
+        std::map<uint8_t, ADCScript> adc_;
+
+        Statistics statistics_;
+
+
+public:
+
+    // Constructor
+    HALHost();
+
+    // Destructor
+    ~HALHost();
+
+
+    // Public Setter Functions
+
+        // Set the end time of the simulation (ms)
+        void setEndTime(const unsigned long long);
+
+        // Set the ADC script of the given analog pin
+        void setADCScript(const uint8_t, const ADCScript&);
+
+        // Set the duration of one ADC conversion (us)
+        void setADCConversionTime(const unsigned long);
+
+        // Advance the virtual clock (us) without checking the end time
+        void advance(const unsigned long long);
+
+
+    // Public Return Functions
+
+        const Statistics& statistics() const { return statistics_; }
+
+        // Virtual time (ms) without wrap around
+        unsigned long long time() const { return t_/1000; }
+
+        // Virtual time (us) without wrap around
+        unsigned long long timeUs() const { return t_; }
+
+
+    // Public Clock Functions
+
+        unsigned long millis() const;
+
+        unsigned long micros() const;
+
+        void delay(const unsigned long);
+
+        void delayMicroseconds(const unsigned int);
+
+
+    // Public IO Functions
+
+        void pinMode(const uint8_t, const uint8_t);
+
+        void digitalWrite(const uint8_t, const uint8_t);
+
+        int digitalRead(const uint8_t) const;
+
+        int analogRead(const uint8_t);
+
+
+    // Public System Functions
+
+        uint32_t freeHeap() const;
+
+        uint32_t maxFreeBlock() const;
+};
+
+
+// * * * * * * * * * * * * * * * Global Functions  * * * * * * * * * * * * * //
+
+// Return the host backend (same object as hal())
+HALHost& halHost();
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,110 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include "heap.h"
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+// * * * * * * * * * * * * * * * Local Data  * * * * * * * * * * * * * * * * //
+
+namespace
+{
+    heap::Statistics statistics_ = {0, 0, 0};
+
+
+    void* allocate(const size_t n)
+    {
+        void* p = malloc(n ? n : 1);
+
+        if (!p)
+        {
+            throw std::bad_alloc();
+        }
+
+        ++statistics_.allocations;
+        statistics_.live += malloc_usable_size(p);
+
+        if (statistics_.live > statistics_.peak)
+        {
+            statistics_.peak = statistics_.live;
+        }
+
+        return p;
+    }
+
+
+    void release(void* p)
+    {
+        if (p)
+        {
+            statistics_.live -= malloc_usable_size(p);
+            free(p);
+        }
+    }
+}
+
+
+// * * * * * * * * * * * * * * * Global Operators  * * * * * * * * * * * * //
+
+void* operator new(size_t n)
+{
+    return allocate(n);
+}
+
+
+void* operator new[](size_t n)
+{
+    return allocate(n);
+}
+
+
+void operator delete(void* p) noexcept
+{
+    release(p);
+}
+
+
+void operator delete[](void* p) noexcept
+{
+    release(p);
+}
+
+
+void operator delete(void* p, size_t) noexcept
+{
+    release(p);
+}
+
+
+void operator delete[](void* p, size_t) noexcept
+{
+    release(p);
+}
+
+
+// * * * * * * * * * * * * * * * Global Functions  * * * * * * * * * * * * * //
+
+const heap::Statistics& heap::statistics()
+{
+    return statistics_;
+}
+
+
+size_t heap::free()
+{
+    return statistics_.live < size ? size - statistics_.live : 0;
+}
+
+
+// ************************************************************************* //
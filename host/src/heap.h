@@ -0,0 +1,54 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+Description
+    Heap model of the host backend. The global operator new/delete are
+    replaced to count the allocations and the live bytes of the process.
+    The free heap of the board is modelled as the DRAM heap of the ESP8266
+    minus the live bytes. Fragmentation is not modelled, hence the largest
+    free block equals the free heap.
+
+SourceFiles
+    heap.cpp
+
+\*---------------------------------------------------------------------------*/
+
+#ifndef heap_h
+#define heap_h
+
+#include <cstddef>
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+namespace heap
+{
+    // Heap size of the modelled board (bytes)
+    const size_t size = 81920;
+
+    struct Statistics
+    {
+        unsigned long allocations;
+        size_t live;
+        size_t peak;
+    };
+
+    // Return the allocation statistics
+    const Statistics& statistics();
+
+    // Return the modelled free heap (bytes)
+    size_t free();
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * //
+
+#endif
+
+// ************************************************************************* //
@@ -0,0 +1,300 @@
+/*---------------------------------------------------------------------------*\
+    =====\\  || \\    //  |
+    ||    \\ ||  \\  //   | Project: BatteryCharger using D1 Wemos
+    ||    || ||   \\//    | Website: https://DIY.Holzmann-cfd.com
+    ||    // ||    ||     | Copyright (C) 2022 Tobias Holzmann
+    =====//  ||    ||     |
+-------------------------------------------------------------------------------
+License
+    This file is part of the BatteryCharger DIY project and is distributed
+    under the terms of the GNU General Public License version 3
+
+\*---------------------------------------------------------------------------*/
+
+#include <LittleFS.h>
+#include <sys/stat.h>
+#include <cerrno>
+
+// * * * * * * * * * * * * * * * Global Objects  * * * * * * * * * * * * * * //
+
+LittleFSHost LittleFS;
+
+
+// * * * * * * * * * * * * * * * * File Members  * * * * * * * * * * * * * * //
+
+File::File(FILE* f, const String& name)
+:
+    f_(f, [](FILE* p) { fclose(p); }),
+    name_(name)
+{}
+
+
+size_t File::write(const uint8_t c)
+{
+    return write(&c, 1);
+}
+
+
+size_t File::write(const uint8_t* buf, size_t n)
+{
+    if (!f_)
+    {
+        return 0;
+    }
+
+    const size_t written = fwrite(buf, 1, n, f_.get());
+    LittleFS.statistics().bytesWritten += written;
+
+    return written;
+}
+
+
+int File::available()
+{
+    if (!f_)
+    {
+        return 0;
+    }
+
+    return int(size() - position());
+}
+
+
+int File::read()
+{
+    if (!f_)
+    {
+        return -1;
+    }
+
+    const int c = fgetc(f_.get());
+
+    if (c != EOF)
+    {
+        ++LittleFS.statistics().bytesRead;
+    }
+
+    return c == EOF ? -1 : c;
+}
+
+
+int File::peek()
+{
+    if (!f_)
+    {
+        return -1;
+    }
+
+    const int c = fgetc(f_.get());
+
+    if (c == EOF)
+    {
+        return -1;
+    }
+
+    ungetc(c, f_.get());
+
+    return c;
+}
+
+
+size_t File::read(uint8_t* buf, const size_t n)
+{
+    if (!f_)
+    {
+        return 0;
+    }
+
+    const size_t nRead = fread(buf, 1, n, f_.get());
+    LittleFS.statistics().bytesRead += nRead;
+
+    return nRead;
+}
+
+
+bool File::seek(const uint32_t pos, const SeekMode mode)
+{
+    if (!f_)
+    {
+        return false;
+    }
+
+    const int whence =
+        mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END);
+
+    return fseek(f_.get(), long(pos), whence) == 0;
+}
+
+
+size_t File::position() const
+{
+    return f_ ? size_t(ftell(f_.get())) : 0;
+}
+
+
+size_t File::size() const
+{
+    if (!f_)
+    {
+        return 0;
+    }
+
+    fflush(f_.get());
+
+    struct stat s;
+
+    if (fstat(fileno(f_.get()), &s) != 0)
+    {
+        return 0;
+    }
+
+    return size_t(s.st_size);
+}
+
+
+void File::flush()
+{
+    if (f_)
+    {
+        fflush(f_.get());
+    }
+}
+
+
+void File::close()
+{
+    f_.reset();
+}
+
+
+// * * * * * * * * * * * * * * LittleFSHost Members  * * * * * * * * * * * * //
+
+LittleFSHost::LittleFSHost()
+:
+    root_("littlefs"),
+    mounted_(false),
+    statistics_{0, 0, 0, 0, 0}
+{}
+
+
+std::string LittleFSHost::path(const char* name) const
+{
+    // Flash names may start with a slash
+    while (*name == '/')
+    {
+        ++name;
+    }
+
+    return root_ + "/" + name;
+}
+
+
+void LittleFSHost::setRoot(const std::string& root)
+{
+    root_ = root;
+}
+
+
+bool LittleFSHost::begin()
+{
+    if (mkdir(root_.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        return false;
+    }
+
+    ++statistics_.mounts;
+    mounted_ = true;
+
+    return true;
+}
+
+
+void LittleFSHost::end()
+{
+    if (mounted_)
+    {
+        ++statistics_.unmounts;
+    }
+
+    mounted_ = false;
+}
+
+
+bool LittleFSHost::info(FSInfo& info) const
+{
+    if (!mounted_)
+    {
+        return false;
+    }
+
+    // Flash layout of the Wemos D1 mini (4M with 2M file system)
+    info.totalBytes = 2072576;
+    info.usedBytes = 0;
+    info.blockSize = 8192;
+    info.pageSize = 256;
+    info.maxOpenFiles = 5;
+    info.maxPathLength = 32;
+
+    return true;
+}
+
+
+bool LittleFSHost::exists(const char* name) const
+{
+    if (!mounted_)
+    {
+        return false;
+    }
+
+    struct stat s;
+
+    return stat(path(name).c_str(), &s) == 0;
+}
+
+
+File LittleFSHost::open(const char* name, const char* mode)
+{
+    if (!mounted_)
+    {
+        return File();
+    }
+
+    // Binary mode, the flash does not translate line endings
+    const std::string m = std::string(mode) + "b";
+
+    FILE* f = fopen(path(name).c_str(), m.c_str());
+
+    if (!f)
+    {
+        return File();
+    }
+
+    ++statistics_.opens;
+
+    return File(f, name);
+}
+
+
+bool LittleFSHost::remove(const char* name)
+{
+    if (!mounted_)
+    {
+        return false;
+    }
+
+    return ::remove(path(name).c_str()) == 0;
+}
+
+
+bool LittleFSHost::rename(const char* nameOld, const char* nameNew)
+{
+    if (!mounted_)
+    {
+        return false;
+    }
+
+    return ::rename(path(nameOld).c_str(), path(nameNew).c_str()) == 0;
+}
+
+
+// ************************************************************************* //